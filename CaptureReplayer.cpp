@@ -0,0 +1,115 @@
+#include "CaptureReplayer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define REPLAY_TICK_INTERVAL            (1)     //ms
+#define REPLAY_SCAN_PER_TICK            (65536) //records looked at per tick
+#define REPLAY_PROGRESS_INTERVAL        (250)   //ms
+
+CaptureReplayer::CaptureReplayer(SerialWorker *worker, QObject *parent)
+    : QObject(parent)
+    , worker(worker)
+    , tickTimer(new QTimer(this))
+{
+    tickTimer->setTimerType(Qt::PreciseTimer);
+    tickTimer->setInterval(REPLAY_TICK_INTERVAL);
+    connect(tickTimer, &QTimer::timeout, this, &CaptureReplayer::onTick);
+}
+
+void CaptureReplayer::start(const QString &path, int replayMode, double replaySpeed)
+{
+    tickTimer->stop();
+
+    QString error;
+    if (!reader.open(path, &error)) {
+        emit finished(false, error);
+        return;
+    }
+
+    mode = static_cast<Mode>(replayMode);
+    speed = (mode == Scaled && replaySpeed > 0.0) ? replaySpeed : 1.0;
+    next = 0;
+    sent = 0;
+    lastProgressMs = 0;
+
+    // 以第一筆 TX 的時間為起點
+    while (next < reader.count() && (reader.at(next).direction != EmuCapture::Tx || reader.at(next).portId != kPort))
+        ++next;
+    firstTs = (next < reader.count()) ? reader.at(next).timestampNs : 0;
+
+    clock.start();
+    tickTimer->start();
+    onTick();
+}
+
+void CaptureReplayer::stop()
+{
+    if (tickTimer->isActive())
+        finish(false, "Replay stopped");
+}
+
+void CaptureReplayer::onTick()
+{
+    const uint64_t count = reader.count();
+    const uint64_t elapsedNs = static_cast<uint64_t>(clock.nsecsElapsed());
+    size_t room = worker->txFree(SerialWorker::BulkLane);
+
+    uint8_t frame[APP_EMU_BURST_FRAME_MAX];
+    for (int scanned = 0; next < count && room > 0 && scanned < REPLAY_SCAN_PER_TICK; ++scanned) {
+        const EmuCapture::Record &rec = reader.at(next);
+        // Burst 的後續資料已跟著前面的 header 一起送出
+        if (rec.direction == EmuCapture::Tx && rec.portId == kPort && rec.kind != EmuCapture::Burst) {
+            if (mode != AsFastAsPossible) {
+                const double due = static_cast<double>(rec.timestampNs - std::min(rec.timestampNs, firstTs)) / speed;
+                if (due > static_cast<double>(elapsedNs))
+                    break;
+            }
+            const int size = gatherFrame(next, frame);
+            const size_t records = static_cast<size_t>((size + APP_EMU_UART_PACKET_LEN - 1) / APP_EMU_UART_PACKET_LEN);
+            if (records > room || !worker->postTx(frame, size, SerialWorker::BulkLane))
+                break;
+            room -= records;
+            ++sent;
+        }
+        ++next;
+    }
+
+    const qint64 nowMs = clock.elapsed();
+    if (nowMs - lastProgressMs >= REPLAY_PROGRESS_INTERVAL) {
+        lastProgressMs = nowMs;
+        emit progress(sent, next, count);
+    }
+
+    if (!worker->isOpen())
+        finish(false, "COM port closed");
+    else if (next >= count)
+        finish(true, QString("Replayed %1 frames").arg(sent));
+}
+
+int CaptureReplayer::gatherFrame(uint64_t index, uint8_t *out) const
+{
+    // 一個 0x8030 burst 記成 header + 多筆 Burst，合成一個封包以單次 postTx
+    // 送出，中間不會插入其他 lane 的封包
+    const EmuCapture::Record &head = reader.at(index);
+    int size = head.size;
+    std::memcpy(out, head.data, head.size);
+    for (uint64_t i = index + 1; i < reader.count(); ++i) {
+        const EmuCapture::Record &rec = reader.at(i);
+        if (rec.direction != EmuCapture::Tx || rec.portId != kPort)
+            continue;       // RX / 其他埠的紀錄可能穿插其中
+        if (rec.kind != EmuCapture::Burst || size + rec.size > APP_EMU_BURST_FRAME_MAX)
+            break;
+        std::memcpy(out + size, rec.data, rec.size);
+        size += rec.size;
+    }
+    return size;
+}
+
+void CaptureReplayer::finish(bool ok, const QString &message)
+{
+    tickTimer->stop();
+    emit progress(sent, next, reader.count());
+    reader.close();
+    emit finished(ok, message);
+}
@@ -0,0 +1,61 @@
+#ifndef CAPTUREREPLAYER_H
+#define CAPTUREREPLAYER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <cstdint>
+
+#include "EmuCaptureReader.h"
+#include "SerialWorker.h"
+
+// Replays the TX records of port kPort of an EmuCapture file through the
+// worker's bulk lane (records of the other ports are skipped). Runs on its
+// own thread.
+//
+//   OriginalTiming    frame i is sent at its recorded offset from the first
+//                     TX frame
+//   Scaled            same, with the offsets divided by `speed`
+//   AsFastAsPossible  no pacing; the bulk lane high-water mark limits the
+//                     rate to what the link drains
+class CaptureReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode { OriginalTiming, Scaled, AsFastAsPossible };
+
+    static constexpr uint8_t kPort = 0;     // recorded port replayed
+
+    explicit CaptureReplayer(SerialWorker *worker, QObject *parent = nullptr);
+
+public slots:
+    void start(const QString &path, int mode, double speed);
+    void stop();
+
+signals:
+    void progress(quint64 sent, quint64 position, quint64 total);
+    void finished(bool ok, const QString &message);
+
+private slots:
+    void onTick();
+
+private:
+    void finish(bool ok, const QString &message);
+    int gatherFrame(uint64_t index, uint8_t *out) const;     // header + its Burst records
+
+    SerialWorker *worker;
+    QTimer *tickTimer;
+    QElapsedTimer clock;
+    EmuCaptureReader reader;
+    Mode mode = OriginalTiming;
+    double speed = 1.0;
+    uint64_t next = 0;          // next record to look at
+    uint64_t firstTs = 0;       // timestamp of the first TX record
+    quint64 sent = 0;
+    qint64 lastProgressMs = 0;
+};
+
+#endif // CAPTUREREPLAYER_H
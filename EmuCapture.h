@@ -0,0 +1,109 @@
+#ifndef EMUCAPTURE_H
+#define EMUCAPTURE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "EmuProtocol.h"
+
+// Binary TX/RX capture file (.emucap), little endian.
+//
+//   FileHeader (64 bytes)
+//   slot[0..]  32-byte slots: kIndexInterval Records, then one IndexBlock,
+//              repeated; the last block may be partial and has no index.
+//
+// Every slot has the same size, so slot k of record i is computable and a
+// multi-GB file can be mmap'ed and seeked without scanning: binary search
+// the IndexBlocks (at known offsets) by time, then the records of one block.
+namespace EmuCapture {
+
+constexpr char kMagic[8] = {'E', 'M', 'U', 'C', 'A', 'P', '0', '1'};
+constexpr uint16_t kVersion = 1;
+constexpr uint32_t kIndexInterval = 4096;      // records per index block
+constexpr uint32_t kIndexMagic = 0x58444E49u;  // "INDX"
+
+enum Direction : uint8_t
+{
+    Tx = 0,
+    Rx = 1
+};
+
+// Same values as EmuRxRecord::Kind for RX; TX uses Frame (or Bulk for the
+// stimulus lane). A 0x8030 burst is its header record followed by Burst
+// records of 16 payload bytes (the last one shorter), in both directions.
+enum Kind : uint8_t
+{
+    Frame = 0,
+    DpecError = 1,
+    Garbage = 2,
+    Remain = 3,
+    Bulk = 4,
+    Burst = 5
+};
+
+struct FileHeader
+{
+    char magic[8];
+    uint16_t version;
+    uint16_t slotSize;
+    uint32_t indexInterval;
+    uint64_t startWallNs;       // system clock (ns since epoch) at timestamp 0
+    uint8_t reserved[40];
+};
+
+struct Record
+{
+    uint64_t timestampNs;       // monotonic, ns since capture start
+    uint8_t direction;
+    uint8_t portId;
+    uint8_t kind;
+    uint8_t size;               // valid bytes in data
+    uint32_t sequence;          // per port, wraps
+    uint8_t data[APP_EMU_UART_PACKET_LEN];
+};
+
+// Timestamps of several ports may interleave slightly out of order, so the
+// index keeps the min / max of its block
+struct IndexBlock
+{
+    uint64_t firstTimestampNs;  // min
+    uint64_t lastTimestampNs;   // max
+    uint64_t firstRecord;       // record number of the first record of the block
+    uint32_t magic;             // kIndexMagic
+    uint32_t count;             // kIndexInterval
+};
+
+constexpr size_t kHeaderSize = sizeof(FileHeader);
+constexpr size_t kSlotSize = 32;
+constexpr size_t kBlockSize = (kIndexInterval + 1) * kSlotSize;
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout");
+static_assert(sizeof(Record) == kSlotSize, "Record layout");
+static_assert(sizeof(IndexBlock) == kSlotSize, "IndexBlock layout");
+
+// File offset of record i
+constexpr uint64_t recordOffset(uint64_t i)
+{
+    return kHeaderSize + (i / kIndexInterval) * kBlockSize + (i % kIndexInterval) * kSlotSize;
+}
+
+// File offset of the index block that follows block b
+constexpr uint64_t indexOffset(uint64_t b)
+{
+    return kHeaderSize + b * kBlockSize + kIndexInterval * kSlotSize;
+}
+
+// Number of complete records in a file of the given size
+constexpr uint64_t recordCount(uint64_t fileSize)
+{
+    if (fileSize < kHeaderSize)
+        return 0;
+    const uint64_t body = fileSize - kHeaderSize;
+    const uint64_t tail = body % kBlockSize;
+    return (body / kBlockSize) * kIndexInterval + std::min<uint64_t>(tail / kSlotSize, kIndexInterval);
+}
+
+} // namespace EmuCapture
+
+#endif // EMUCAPTURE_H
@@ -0,0 +1,74 @@
+#include "EmuCaptureReader.h"
+
+#include <cstring>
+
+using namespace EmuCapture;
+
+bool EmuCaptureReader::open(const QString &path, QString *error)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size < static_cast<qint64>(kHeaderSize)) {
+        if (error)
+            *error = "Not a capture file";
+        file.close();
+        return false;
+    }
+
+    base = file.map(0, size);
+    if (!base) {
+        if (error)
+            *error = file.errorString();
+        file.close();
+        return false;
+    }
+
+    const FileHeader &h = header();
+    if (std::memcmp(h.magic, kMagic, sizeof(h.magic)) != 0 || h.slotSize != kSlotSize ||
+        h.indexInterval != kIndexInterval) {
+        if (error)
+            *error = "Unsupported capture format";
+        close();
+        return false;
+    }
+
+    records = recordCount(static_cast<uint64_t>(size));
+    return true;
+}
+
+void EmuCaptureReader::close()
+{
+    if (base)
+        file.unmap(const_cast<uchar *>(base));
+    base = nullptr;
+    records = 0;
+    if (file.isOpen())
+        file.close();
+}
+
+uint64_t EmuCaptureReader::lowerBound(uint64_t t) const
+{
+    // 以 index block 二分搜尋，再於單一 block 內線性搜尋
+    const uint64_t blocks = records / kIndexInterval;
+    uint64_t lo = 0, hi = blocks;
+    while (lo < hi) {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        if (index(mid).lastTimestampNs < t)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for (uint64_t i = lo * kIndexInterval; i < records; ++i)
+        if (at(i).timestampNs >= t)
+            return i;
+    return records;
+}
@@ -0,0 +1,51 @@
+#ifndef EMUCAPTUREREADER_H
+#define EMUCAPTUREREADER_H
+
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+
+#include "EmuCapture.h"
+
+// Read-only, memory mapped view of an EmuCapture file.
+//
+// Records are addressed by number through EmuCapture::recordOffset, so
+// at() is O(1) and lowerBound() only touches the index blocks plus one
+// block of records, whatever the file size.
+class EmuCaptureReader
+{
+public:
+    EmuCaptureReader() = default;
+    ~EmuCaptureReader() { close(); }
+
+    EmuCaptureReader(const EmuCaptureReader &) = delete;
+    EmuCaptureReader &operator=(const EmuCaptureReader &) = delete;
+
+    bool open(const QString &path, QString *error = nullptr);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    const EmuCapture::FileHeader &header() const { return *reinterpret_cast<const EmuCapture::FileHeader *>(base); }
+    uint64_t count() const { return records; }
+
+    const EmuCapture::Record &at(uint64_t i) const
+    {
+        return *reinterpret_cast<const EmuCapture::Record *>(base + EmuCapture::recordOffset(i));
+    }
+
+    // First record with timestampNs >= t (count() if none)
+    uint64_t lowerBound(uint64_t t) const;
+
+private:
+    const EmuCapture::IndexBlock &index(uint64_t b) const
+    {
+        return *reinterpret_cast<const EmuCapture::IndexBlock *>(base + EmuCapture::indexOffset(b));
+    }
+
+    QFile file;
+    const uchar *base = nullptr;
+    uint64_t records = 0;
+};
+
+#endif // EMUCAPTUREREADER_H
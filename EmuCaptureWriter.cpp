@@ -0,0 +1,206 @@
+#include "EmuCaptureWriter.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace EmuCapture;
+
+EmuCaptureWriter::Source::Source(EmuCaptureWriter *owner, uint8_t portId)
+    : writer(owner)
+    , port(portId)
+    , queue(kSourceQueueLen)
+{
+}
+
+bool EmuCaptureWriter::Source::record(Direction dir, Kind kind, const uint8_t *data, int size)
+{
+    if (!writer->isRunning())
+        return false;
+
+    Record rec;
+    rec.timestampNs = writer->nowNs();
+    rec.direction = dir;
+    rec.portId = port;
+    rec.kind = kind;
+    rec.size = static_cast<uint8_t>(std::min(std::max(size, 0), APP_EMU_UART_PACKET_LEN));
+    rec.sequence = sequence++;
+    std::memcpy(rec.data, data, rec.size);
+    std::memset(rec.data + rec.size, 0, sizeof(rec.data) - rec.size);
+
+    if (!queue.push(rec)) {
+        drops.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+EmuCaptureWriter::EmuCaptureWriter()
+    : buffer(kBufferSize)
+{
+}
+
+EmuCaptureWriter::~EmuCaptureWriter()
+{
+    stop();
+}
+
+EmuCaptureWriter::Source *EmuCaptureWriter::source(uint8_t portId)
+{
+    std::lock_guard<std::mutex> guard(sourceLock);
+    const size_t n = sourceCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < n; ++i)
+        if (sources[i]->portId() == portId)
+            return sources[i].get();
+    if (n == kMaxSources)
+        return nullptr;
+
+    sources[n].reset(new Source(this, portId));
+    sourceCount.store(n + 1, std::memory_order_release);
+    return sources[n].get();
+}
+
+uint64_t EmuCaptureWriter::nowNs() const
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - origin).count());
+}
+
+bool EmuCaptureWriter::start(const char *path)
+{
+    stop();
+
+    file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+    std::setvbuf(file, nullptr, _IONBF, 0);    // 已自行緩衝
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.slotSize = static_cast<uint16_t>(kSlotSize);
+    header.indexInterval = kIndexInterval;
+    header.startWallNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    // 丟掉上次停止後才排入的紀錄
+    Record discard[256];
+    const size_t n = sourceCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < n; ++i)
+        while (sources[i]->queue.pop(discard, 256) > 0) {}
+
+    used = 0;
+    recordNo = 0;
+    block = IndexBlock{};
+    records.store(0, std::memory_order_relaxed);
+    fileBytes.store(sizeof(header), std::memory_order_relaxed);
+    error.store(false, std::memory_order_relaxed);
+    origin = std::chrono::steady_clock::now();
+
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&EmuCaptureWriter::run, this);
+    return true;
+}
+
+void EmuCaptureWriter::stop()
+{
+    if (!thread.joinable())
+        return;
+    running.store(false, std::memory_order_release);
+    thread.join();
+
+    // 緩衝已自行管理，fclose 失敗仍代表檔案不完整
+    if (std::fclose(file) != 0)
+        error.store(true, std::memory_order_release);
+    file = nullptr;
+}
+
+void EmuCaptureWriter::run()
+{
+    auto lastFlush = std::chrono::steady_clock::now();
+
+    for (;;) {
+        const bool stopping = !running.load(std::memory_order_acquire);
+        const size_t n = drainSources();
+
+        const auto now = std::chrono::steady_clock::now();
+        if (used > 0 && (stopping || now - lastFlush >= std::chrono::milliseconds(kFlushIntervalMs))) {
+            flush();
+            lastFlush = now;
+        }
+        if (stopping && n == 0)
+            break;
+        if (n == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+size_t EmuCaptureWriter::drainSources()
+{
+    Record batch[256];
+    size_t total = 0;
+    const size_t count = sourceCount.load(std::memory_order_acquire);
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t n;
+        while ((n = sources[i]->queue.pop(batch, 256)) > 0) {
+            for (size_t k = 0; k < n; ++k)
+                append(batch[k]);
+            total += n;
+        }
+    }
+    return total;
+}
+
+void EmuCaptureWriter::append(const Record &rec)
+{
+    if (used + 2 * kSlotSize > buffer.size())
+        flush();
+
+    const uint32_t inBlock = static_cast<uint32_t>(recordNo % kIndexInterval);
+    if (inBlock == 0) {
+        block.firstTimestampNs = rec.timestampNs;
+        block.lastTimestampNs = rec.timestampNs;
+        block.firstRecord = recordNo;
+    } else {
+        block.firstTimestampNs = std::min(block.firstTimestampNs, rec.timestampNs);
+        block.lastTimestampNs = std::max(block.lastTimestampNs, rec.timestampNs);
+    }
+
+    std::memcpy(buffer.data() + used, &rec, kSlotSize);
+    used += kSlotSize;
+    ++recordNo;
+
+    // 每 kIndexInterval 筆補一個 index block
+    if (inBlock == kIndexInterval - 1) {
+        block.magic = kIndexMagic;
+        block.count = kIndexInterval;
+        std::memcpy(buffer.data() + used, &block, kSlotSize);
+        used += kSlotSize;
+    }
+}
+
+void EmuCaptureWriter::flush()
+{
+    if (used == 0)
+        return;
+    if (error.load(std::memory_order_relaxed)) {
+        used = 0;     // 已失敗: 只把佇列清空
+        return;
+    }
+    const size_t written = std::fwrite(buffer.data(), 1, used, file);
+    fileBytes.fetch_add(written, std::memory_order_relaxed);
+    const bool complete = (written == used);
+    used = 0;
+    if (!complete) {
+        // 磁碟滿 / 裝置移除: 停止紀錄，之後的 record() 直接回傳 false
+        error.store(true, std::memory_order_release);
+        running.store(false, std::memory_order_release);
+        return;
+    }
+    records.store(recordNo, std::memory_order_relaxed);
+}
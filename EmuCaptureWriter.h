@@ -0,0 +1,102 @@
+#ifndef EMUCAPTUREWRITER_H
+#define EMUCAPTUREWRITER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "EmuCapture.h"
+#include "SpscQueue.h"
+
+// Writes an EmuCapture file on its own thread.
+//
+// Each producer thread (normally the serial worker of one port) records into
+// its own Source, which is a lock-free SPSC queue, so recording costs the
+// serial path one timestamp and one 32-byte copy. The writer thread batches
+// records into a large buffer and writes it with a single fwrite when it is
+// full or every kFlushIntervalMs. Records that do not fit in a full queue
+// are counted, never waited for.
+//
+// A short write (disk full, removed drive) or a failing fclose latches
+// failed(): recording stops right away, isRunning() turns false and the
+// file keeps what was written before; stop() still has to be called.
+class EmuCaptureWriter
+{
+public:
+    static constexpr size_t kMaxSources = 16;
+    static constexpr size_t kSourceQueueLen = 65536;
+    static constexpr size_t kBufferSize = 1 << 20;
+    static constexpr int kFlushIntervalMs = 250;
+
+    class Source
+    {
+    public:
+        // Producer thread only; false when not capturing or the queue is full
+        bool record(EmuCapture::Direction dir, EmuCapture::Kind kind, const uint8_t *data, int size);
+
+        uint8_t portId() const { return port; }
+        uint64_t dropped() const { return drops.load(std::memory_order_relaxed); }
+
+    private:
+        friend class EmuCaptureWriter;
+        Source(EmuCaptureWriter *owner, uint8_t portId);
+
+        EmuCaptureWriter *writer;
+        uint8_t port;
+        uint32_t sequence = 0;
+        SpscQueue<EmuCapture::Record> queue;
+        std::atomic<uint64_t> drops{0};
+    };
+
+    EmuCaptureWriter();
+    ~EmuCaptureWriter();
+
+    EmuCaptureWriter(const EmuCaptureWriter &) = delete;
+    EmuCaptureWriter &operator=(const EmuCaptureWriter &) = delete;
+
+    // Source of a port, created on first use; stays valid for the lifetime
+    // of the writer, across start() / stop()
+    Source *source(uint8_t portId);
+
+    bool start(const char *path);
+    void stop();    // writes everything queued so far, then closes the file
+
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+    bool failed() const { return error.load(std::memory_order_acquire); }     // since start()
+    uint64_t recordsWritten() const { return records.load(std::memory_order_relaxed); }
+    uint64_t bytesWritten() const { return fileBytes.load(std::memory_order_relaxed); }
+
+    // Monotonic ns since start()
+    uint64_t nowNs() const;
+
+private:
+    void run();
+    size_t drainSources();
+    void append(const EmuCapture::Record &rec);
+    void flush();
+
+    std::mutex sourceLock;      // source() creation only
+    std::unique_ptr<Source> sources[kMaxSources];
+    std::atomic<size_t> sourceCount{0};
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> error{false};
+    std::FILE *file = nullptr;
+    std::chrono::steady_clock::time_point origin;
+
+    // Writer thread state
+    std::vector<uint8_t> buffer;
+    size_t used = 0;
+    uint64_t recordNo = 0;
+    EmuCapture::IndexBlock block{};
+    std::atomic<uint64_t> records{0};
+    std::atomic<uint64_t> fileBytes{0};
+};
+
+#endif // EMUCAPTUREWRITER_H
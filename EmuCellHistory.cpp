@@ -0,0 +1,72 @@
+#include "EmuCellHistory.h"
+
+#include <algorithm>
+#include <cmath>
+
+void EmuCellHistory::reset()
+{
+    rings.clear();
+    originNs = 0;
+    latest = 0;
+}
+
+void EmuCellHistory::append(int afe, int group, const uint16_t *codes, uint64_t timestampNs)
+{
+    if (afe < 0 || afe >= APP_AFECASE_NUM_MAX || group < 0 || group >= kCellGroups)
+        return;
+    if (static_cast<size_t>(afe) >= rings.size() / kCellGroups)
+        rings.resize((static_cast<size_t>(afe) + 1) * kCellGroups);
+    if (originNs == 0)
+        originNs = timestampNs;
+    latest = std::max(latest, timestampNs);
+
+    Ring &r = rings[static_cast<size_t>(afe) * kCellGroups + static_cast<size_t>(group)];
+    if (r.samples.empty())
+        r.samples.resize(kDepth);
+    Sample &s = r.samples[r.next];
+    s.timeMs = static_cast<uint32_t>((timestampNs - std::min(timestampNs, originNs)) / 1000000u);
+    s.code[0] = codes[0];
+    s.code[1] = codes[1];
+    s.code[2] = codes[2];
+    r.next = (r.next + 1) % kDepth;
+    r.size = std::min<uint32_t>(r.size + 1, kDepth);
+}
+
+size_t EmuCellHistory::decimate(int afe, int channel, uint64_t fromNs, uint64_t toNs, int buckets,
+                                float *minV, float *maxV) const
+{
+    if (buckets <= 0)
+        return 0;
+    std::fill(minV, minV + buckets, NAN);
+    std::fill(maxV, maxV + buckets, NAN);
+    if (afe < 0 || afe >= afeCount() || channel < 0 || channel >= kCellChannels || toNs <= fromNs)
+        return 0;
+
+    const Ring &r = rings[static_cast<size_t>(afe) * kCellGroups + static_cast<size_t>(channel / 3)];
+    const int i = channel % 3;
+    // 視窗換算成 sample 的 ms 刻度，結尾進位以免最新一筆落在視窗外
+    const int64_t from = (static_cast<int64_t>(fromNs) - static_cast<int64_t>(originNs)) / 1000000;
+    const int64_t to = (static_cast<int64_t>(toNs) - static_cast<int64_t>(originNs) + 999999) / 1000000;
+    const int64_t span = std::max<int64_t>(to - from, 1);
+
+    // 由最新往回走，超出視窗就停
+    size_t seen = 0;
+    for (uint32_t k = 0; k < r.size; ++k) {
+        const Sample &s = r.samples[(r.next + kDepth - 1 - k) % kDepth];
+        const int64_t t = static_cast<int64_t>(s.timeMs) - from;
+        if (t < 0)
+            break;
+        if (t >= span)
+            continue;
+        const int b = static_cast<int>(t * buckets / span);
+        const float v = static_cast<float>(s.code[i] * 150e-6 + 1.5);
+        if (std::isnan(minV[b])) {
+            minV[b] = maxV[b] = v;
+        } else {
+            minV[b] = std::min(minV[b], v);
+            maxV[b] = std::max(maxV[b], v);
+        }
+        ++seen;
+    }
+    return seen;
+}
@@ -0,0 +1,58 @@
+#ifndef EMUCELLHISTORY_H
+#define EMUCELLHISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EmuChainModel.h"
+
+// Fixed-depth time history of the cell voltages of one board.
+//
+// One ring of kDepth samples per AFE per cell group (RDCVA~F), each sample
+// the receive time and the three raw codes of one frame, so memory is
+// bounded (kDepth x 12 bytes x 6 groups per AFE) however long the link
+// runs. Rings are allocated for the AFEs actually received.
+//
+// decimate() reduces one channel over a time window to per-bucket min/max
+// (one bucket per screen pixel), so drawing a trace costs the plot width,
+// not the number of samples.
+class EmuCellHistory
+{
+public:
+    static constexpr int kDepth = 1024;
+    static constexpr int kCellGroups = 6;
+    static constexpr int kCellChannels = EmuChainModel::kCellChannels;
+
+    // group 0~5 = RDCVA~F, codes as received (code x 150uV + 1.5V)
+    void append(int afe, int group, const uint16_t *codes, uint64_t timestampNs);
+    void reset();
+
+    int afeCount() const { return static_cast<int>(rings.size() / kCellGroups); }
+    uint64_t latestNs() const { return latest; }      // 0 before the first sample
+
+    // min/max in V of cell `channel` (0~17) of `afe` over [fromNs, toNs) in
+    // `buckets` equal slices; empty buckets get NaN. Returns the samples seen.
+    size_t decimate(int afe, int channel, uint64_t fromNs, uint64_t toNs, int buckets,
+                    float *minV, float *maxV) const;
+
+private:
+    struct Sample
+    {
+        uint32_t timeMs;        // since the first sample
+        uint16_t code[3];
+    };
+
+    struct Ring
+    {
+        std::vector<Sample> samples;    // kDepth once the first sample arrived
+        uint32_t next = 0;
+        uint32_t size = 0;
+    };
+
+    std::vector<Ring> rings;        // [afe][group]
+    uint64_t originNs = 0;
+    uint64_t latest = 0;
+};
+
+#endif // EMUCELLHISTORY_H
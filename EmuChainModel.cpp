@@ -0,0 +1,185 @@
+#include "EmuChainModel.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "LibPecBatchCalc.h"
+
+namespace {
+
+// 6 data bytes + command counter (0, as encodeRegGroup) + pad
+constexpr size_t kPayloadStride = 8;
+constexpr int kAuxGroupBase = 6;    // index of RDAUXA in EmuFrame::kRegGroups
+constexpr int kCfgGroupBase = 11;   // index of RDCFGA
+
+} // namespace
+
+EmuChainModel::EmuChainModel(int afeCount)
+{
+    resize(afeCount);
+}
+
+void EmuChainModel::resize(int afeCount)
+{
+    afeCount = std::max(afeCount, 1);
+    if (afeCount == count)
+        return;
+
+    // 以通道為單位重新排列，保留原有 AFE 的值
+    auto reshape = [this, afeCount](std::vector<double> &v, int channels) {
+        std::vector<double> next(static_cast<size_t>(channels) * static_cast<size_t>(afeCount), 0.0);
+        const int keep = std::min(count, afeCount);
+        for (int ch = 0; ch < channels && keep > 0; ++ch)
+            std::copy_n(&v[static_cast<size_t>(ch) * static_cast<size_t>(count)], keep,
+                        &next[static_cast<size_t>(ch) * static_cast<size_t>(afeCount)]);
+        v.swap(next);
+    };
+    reshape(cells, kCellChannels);
+    reshape(aux, kAuxChannels);
+    cfg.resize(static_cast<size_t>(afeCount) * kCfgGroups * EmuFrame::kRegDataLen, 0);
+    count = afeCount;
+}
+
+void EmuChainModel::fillCells(double volts)
+{
+    std::fill(cells.begin(), cells.end(), volts);
+}
+
+void EmuChainModel::fillAux(double volts)
+{
+    std::fill(aux.begin(), aux.end(), volts);
+}
+
+void EmuChainModel::voltsToCodes(const double *volts, uint16_t *codes, size_t n)
+{
+    // Branch-free so it vectorizes; the arithmetic matches voltageToCode
+    for (size_t i = 0; i < n; ++i) {
+        double c = (volts[i] * 1000000.0 - 1500000.0) / 150.0;
+        c = c < 0.0 ? 0.0 : c;
+        c = c > 65535.0 ? 65535.0 : c;
+        codes[i] = static_cast<uint16_t>(static_cast<int32_t>(c));
+    }
+}
+
+size_t EmuChainModel::buildPayload(uint32_t groupMask, int *groups, int &groupCount)
+{
+    const size_t n = static_cast<size_t>(count);
+    groupCount = 0;
+    for (int g = 0; g < EmuFrame::kRegGroupCount; ++g)
+        if (groupMask & (1u << g))
+            groups[groupCount++] = g;
+    if (groupCount == 0)
+        return 0;
+
+    // 1. Voltage -> code for every channel of the chain
+    codes.resize((kCellChannels + kAuxChannels) * n);
+    if (groupMask & kCellGroupsMask)
+        voltsToCodes(cells.data(), codes.data(), cells.size());
+    if (groupMask & kAuxGroupsMask)
+        voltsToCodes(aux.data(), codes.data() + kCellChannels * n, aux.size());
+
+    // 2. Payloads, AFE-major, with a zero command counter after the data
+    const size_t frames = n * static_cast<size_t>(groupCount);
+    payload.assign(frames * kPayloadStride, 0);
+    uint8_t *p = payload.data();
+    for (size_t afe = 0; afe < n; ++afe) {
+        for (int k = 0; k < groupCount; ++k, p += kPayloadStride) {
+            const int g = groups[k];
+            if (g >= kCfgGroupBase) {
+                std::memcpy(p, config(static_cast<int>(afe), g - kCfgGroupBase), EmuFrame::kRegDataLen);
+                continue;
+            }
+            // cells: channel 3g..; aux: channel 18 + 3(g-6)..
+            const size_t firstChannel = (g < kAuxGroupBase) ? static_cast<size_t>(g) * 3
+                                                            : kCellChannels + static_cast<size_t>(g - kAuxGroupBase) * 3;
+            for (size_t i = 0; i < 3; ++i) {
+                const uint16_t c = codes[(firstChannel + i) * n + afe];
+                p[2 * i] = static_cast<uint8_t>(c & 0xFF);
+                p[2 * i + 1] = static_cast<uint8_t>(c >> 8);
+            }
+        }
+    }
+
+    // 3. DPEC of the whole chain in one batch
+    dpec.resize(frames);
+    pec10_calc_batch(true, EmuFrame::kRegDataLen, payload.data(), kPayloadStride, frames, dpec.data());
+    return frames;
+}
+
+size_t EmuChainModel::generate(uint32_t groupMask, std::vector<EmuFrame::Frame> &out)
+{
+    const size_t n = static_cast<size_t>(count);
+    int groups[EmuFrame::kRegGroupCount];
+    int groupCount = 0;
+    const size_t frames = buildPayload(groupMask, groups, groupCount);
+    if (frames == 0)
+        return 0;
+
+    // 4. Frames: constant prefix + AFE index + payload + DPEC + checksum
+    const size_t before = out.size();
+    out.resize(before + frames);
+    EmuFrame::Frame *f = out.data() + before;
+    const uint8_t *p = payload.data();
+    const uint16_t *crc = dpec.data();
+    for (size_t afe = 0; afe < n; ++afe) {
+        for (int k = 0; k < groupCount; ++k, ++f, p += kPayloadStride, ++crc) {
+            const uint16_t cmd = EmuFrame::kRegGroups[groups[k]].cmd;
+            *f = EmuFrame::prefix(cmd);
+            (*f)[APP_EMU_A_AFEINDEX] = static_cast<uint8_t>(afe & 0xFF);
+            (*f)[APP_EMU_A_AFEINDEX_HI] = static_cast<uint8_t>(afe >> 8);
+            std::memcpy(f->data() + APP_EMU_A_DATA, p, EmuFrame::kRegDataLen);
+            (*f)[APP_EMU_A_DPEC1] = static_cast<uint8_t>(*crc >> 8);
+            (*f)[APP_EMU_A_DPEC2] = static_cast<uint8_t>(*crc & 0xFF);
+
+            uint8_t sum = static_cast<uint8_t>(EmuFrame::prefixSum(cmd) + (*f)[APP_EMU_A_AFEINDEX_HI]);
+            for (int i = APP_EMU_A_AFEINDEX; i < APP_EMU_A_CHECKSUM; ++i)
+                sum = static_cast<uint8_t>(sum + (*f)[static_cast<size_t>(i)]);
+            (*f)[APP_EMU_A_CHECKSUM] = sum;
+        }
+    }
+    return frames;
+}
+
+size_t EmuChainModel::generateBursts(uint32_t groupMask, std::vector<uint8_t> &out)
+{
+    const size_t n = static_cast<size_t>(count);
+    int groups[EmuFrame::kRegGroupCount];
+    int groupCount = 0;
+    const size_t records = buildPayload(groupMask, groups, groupCount);
+    if (records == 0)
+        return 0;
+
+    // The payload stride is already the burst record layout, DPEC goes in place
+    static_assert(kPayloadStride == EmuFrame::kBurstRecordLen, "payload stride is a burst record");
+    for (size_t r = 0; r < records; ++r) {
+        payload[r * kPayloadStride + EmuFrame::kRegDataLen] = static_cast<uint8_t>(dpec[r] >> 8);
+        payload[r * kPayloadStride + EmuFrame::kRegDataLen + 1] = static_cast<uint8_t>(dpec[r] & 0xFF);
+    }
+
+    size_t bursts = 0;
+    for (int k = 0; k < groupCount;) {
+        int run = 1;
+        while (k + run < groupCount && groups[k + run] == groups[k] + run)
+            ++run;
+        const size_t runBytes = static_cast<size_t>(run) * kPayloadStride;
+        const size_t afesPerBurst = static_cast<size_t>(EmuFrame::kBurstMaxRecords / run);
+
+        for (size_t afe = 0; afe < n; afe += afesPerBurst, ++bursts) {
+            const size_t afes = std::min(afesPerBurst, n - afe);
+            const size_t len = afes * runBytes;
+            const size_t at = out.size();
+            out.resize(at + APP_EMU_UART_PACKET_LEN + len);
+            uint8_t *dst = out.data() + at + APP_EMU_UART_PACKET_LEN;
+            // 一次只取這段 group 的 record（payload 為 AFE-major）
+            for (size_t i = 0; i < afes; ++i)
+                std::memcpy(dst + i * runBytes,
+                            &payload[((afe + i) * static_cast<size_t>(groupCount) + static_cast<size_t>(k)) * kPayloadStride],
+                            runBytes);
+            const EmuFrame::Frame header = EmuFrame::encodeBurstHeader(
+                static_cast<uint16_t>(afe), static_cast<uint16_t>(afes), groups[k], run, dst, static_cast<int>(len));
+            std::memcpy(out.data() + at, header.data(), header.size());
+        }
+        k += run;
+    }
+    return bursts;
+}
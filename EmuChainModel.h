@@ -0,0 +1,81 @@
+#ifndef EMUCHAINMODEL_H
+#define EMUCHAINMODEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EmuFrame.h"
+
+// In-memory state of the whole AFE chain, stored as structure of arrays.
+//
+// Every cell / aux channel is one contiguous array indexed by AFE, so the
+// voltage -> code conversion of the whole chain is a single tight loop the
+// compiler vectorizes, and the register group payloads are assembled with
+// their DPEC computed by pec10_calc_batch (AVX2 when available) instead of
+// one scalar CRC per frame. The config registers (CFGA/CFGB) are kept as
+// raw bytes per AFE.
+//
+// Channel numbering follows the register groups: cells 0..17 are RDCVA~F
+// (3 per group), aux 0..14 are RDAUXA~E.
+class EmuChainModel
+{
+public:
+    static constexpr int kCellChannels = 18;
+    static constexpr int kAuxChannels = 15;
+    static constexpr int kCfgGroups = 2;
+
+    // Bit i selects EmuFrame::kRegGroups[i]
+    static constexpr uint32_t kCellGroupsMask = 0x003F;     // RDCVA~F
+    static constexpr uint32_t kAuxGroupsMask = 0x07C0;      // RDAUXA~E
+    static constexpr uint32_t kCfgGroupsMask = 0x1800;      // RDCFGA/B
+
+    explicit EmuChainModel(int afeCount = 1);
+
+    void resize(int afeCount);      // keeps the values of the remaining AFEs
+    int afeCount() const { return count; }
+
+    // Contiguous per-channel arrays of afeCount() voltages (V)
+    double *cellVolts(int channel) { return &cells[static_cast<size_t>(channel) * static_cast<size_t>(count)]; }
+    const double *cellVolts(int channel) const { return &cells[static_cast<size_t>(channel) * static_cast<size_t>(count)]; }
+    double *auxVolts(int channel) { return &aux[static_cast<size_t>(channel) * static_cast<size_t>(count)]; }
+    const double *auxVolts(int channel) const { return &aux[static_cast<size_t>(channel) * static_cast<size_t>(count)]; }
+
+    // 6 raw bytes of CFGA (group 0) / CFGB (group 1) of one AFE
+    uint8_t *config(int afe, int group) { return &cfg[(static_cast<size_t>(afe) * kCfgGroups + static_cast<size_t>(group)) * EmuFrame::kRegDataLen]; }
+    const uint8_t *config(int afe, int group) const { return &cfg[(static_cast<size_t>(afe) * kCfgGroups + static_cast<size_t>(group)) * EmuFrame::kRegDataLen]; }
+
+    void fillCells(double volts);
+    void fillAux(double volts);
+
+    // One frame per selected group per AFE, AFE-major in kRegGroups order
+    // (same order as writing them one by one), appended to out; returns the
+    // number of frames. The frames are identical to EmuFrame::encodeRegGroup.
+    size_t generate(uint32_t groupMask, std::vector<EmuFrame::Frame> &out);
+
+    // Same registers as 0x8030 burst frames (header + payload, back to back)
+    // appended to out; returns the number of bursts. Each contiguous run of
+    // selected groups is sent for as many AFEs as fit in one burst.
+    size_t generateBursts(uint32_t groupMask, std::vector<uint8_t> &out);
+
+    // Bulk (V - 1.5V) / 150uV, clamped to the 16-bit register range; same
+    // result as StimulusGenerator::voltageToCode for every element
+    static void voltsToCodes(const double *volts, uint16_t *codes, size_t n);
+
+private:
+    // Steps 1~3 of generate(): payload + dpec of every selected group of
+    // every AFE; returns the number of records
+    size_t buildPayload(uint32_t groupMask, int *groups, int &groupCount);
+
+    int count = 0;
+    std::vector<double> cells;      // [channel][afe]
+    std::vector<double> aux;        // [channel][afe]
+    std::vector<uint8_t> cfg;       // [afe][group][6]
+
+    // generate() scratch, kept to avoid reallocation per refresh
+    std::vector<uint16_t> codes;    // [channel][afe], cells then aux
+    std::vector<uint8_t> payload;   // [frame][kPayloadStride]
+    std::vector<uint16_t> dpec;     // [frame]
+};
+
+#endif // EMUCHAINMODEL_H
@@ -0,0 +1,159 @@
+#include "EmuFirmwareModel.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kRegBytes = EmuFrame::kRegDataLen;
+constexpr size_t kAfeBytes = EmuFrame::kRegGroupCount * kRegBytes;
+
+} // namespace
+
+EmuFirmwareModel::EmuFirmwareModel()
+    : regs(kMaxAfes * kAfeBytes, 0)
+{
+}
+
+void EmuFirmwareModel::reset()
+{
+    decoder.reset();
+    total = 1;
+    mode = 0;
+    std::fill(regs.begin(), regs.end(), 0);
+    counters = Stats();
+}
+
+int EmuFirmwareModel::rangeGroup(uint8_t cmdType)
+{
+    if (cmdType >= 0x01 && cmdType <= 0x06)
+        return cmdType - 0x01;          // RDCVA~F
+    if (cmdType >= 0x11 && cmdType <= 0x15)
+        return 6 + cmdType - 0x11;      // RDAUXA~E
+    if (cmdType == 0x20 || cmdType == 0x21)
+        return 11 + cmdType - 0x20;     // RDCFGA/B
+    return -1;
+}
+
+const uint8_t *EmuFirmwareModel::registers(int afe, int group) const
+{
+    if (afe < 0 || afe >= kMaxAfes || group < 0 || group >= EmuFrame::kRegGroupCount)
+        return nullptr;
+    return &regs[static_cast<size_t>(afe) * kAfeBytes + static_cast<size_t>(group) * kRegBytes];
+}
+
+size_t EmuFirmwareModel::feed(const uint8_t *data, size_t size, std::vector<EmuFrame::Frame> &responses)
+{
+    const size_t before = responses.size();
+    EmuFrameDecoder::Item item;
+
+    while (size > 0) {
+        const size_t n = decoder.write(data, size);
+        data += n;
+        size -= n;
+
+        while (decoder.next(item)) {
+            if (item.kind == EmuFrameDecoder::Item::Garbage) {
+                counters.droppedBytes += static_cast<uint64_t>(item.size);
+                continue;
+            }
+            if (EmuFrame::isBurst(item.data)) {
+                responses.push_back(EmuFrame::encodeBurstAck(item.data, applyBurst(item.data)));
+                continue;
+            }
+            if (item.hasDpec && !item.dpecOk)
+                ++counters.dpecErrors;
+            else
+                apply(item.data);
+
+            EmuFrame::Frame echo;
+            std::memcpy(echo.data(), item.data, echo.size());
+            responses.push_back(echo);
+        }
+    }
+    return responses.size() - before;
+}
+
+void EmuFirmwareModel::apply(const uint8_t *frame)
+{
+    EmuFrame::Decoded d;
+    if (EmuFrame::decode(frame, d) != EmuFrame::Status::Ok)
+        return;
+    ++counters.frames;
+
+    if (d.isRegGroup) {
+        const int group = EmuFrame::regGroupIndex(d.cmd);
+        if (group < 0 || d.afeIndex >= kMaxAfes) {
+            ++counters.unknownCommands;
+            return;
+        }
+        std::memcpy(&regs[d.afeIndex * kAfeBytes + static_cast<size_t>(group) * kRegBytes], d.data, kRegBytes);
+        ++counters.regWrites;
+        return;
+    }
+
+    ++counters.controlFrames;
+    switch (d.cmd) {
+    case APP_CMD_AFE_NUM:
+        total = std::min<int>(std::max<int>(d.afeTotal(), 1), kMaxAfes);
+        if (d.initDevice())
+            std::fill(regs.begin(), regs.end(), 0);
+        break;
+
+    case APP_CMD_AFE_V_INC: {
+        const int group = rangeGroup(d.rangeCmdType());
+        if (group < 0) {
+            ++counters.unknownCommands;
+            break;
+        }
+        const int last = std::min<int>(d.rangeEndIndex(), kMaxAfes - 1);
+        for (int afe = d.rangeStartIndex(); afe <= last; ++afe) {
+            const uint16_t code = static_cast<uint16_t>(d.rangeStart() + (afe - d.rangeStartIndex()) * d.rangeStep());
+            uint8_t *r = &regs[static_cast<size_t>(afe) * kAfeBytes + static_cast<size_t>(group) * kRegBytes];
+            for (size_t i = 0; i < kRegBytes; i += 2) {
+                r[i] = static_cast<uint8_t>(code & 0xFF);
+                r[i + 1] = static_cast<uint8_t>(code >> 8);
+            }
+        }
+        break;
+    }
+
+    case APP_CMD_AFE_SPIMODE:
+        mode = static_cast<uint8_t>(d.spiMode() & 0x03);
+        break;
+
+    default:
+        ++counters.unknownCommands;
+        break;
+    }
+}
+
+uint8_t EmuFirmwareModel::applyBurst(const uint8_t *frame)
+{
+    EmuFrame::Decoded d;
+    if (EmuFrame::decode(frame, d) != EmuFrame::Status::Ok)
+        return 0;
+    ++counters.frames;
+    ++counters.bursts;
+
+    const int groups = d.burstGroupCount();
+    const int records = d.burstLength() / EmuFrame::kBurstRecordLen;
+    const uint8_t *rec = frame + APP_EMU_UART_PACKET_LEN;
+    int dropped = 0;
+    for (int r = 0; r < records; ++r, rec += EmuFrame::kBurstRecordLen) {
+        const int afe = d.afeIndex + r / groups;
+        if (!EmuFrame::burstRecordOk(rec)) {
+            ++counters.dpecErrors;
+            ++dropped;
+            continue;
+        }
+        if (afe >= kMaxAfes) {
+            ++counters.unknownCommands;
+            continue;
+        }
+        const size_t group = static_cast<size_t>(d.burstFirstGroup() + r % groups);
+        std::memcpy(&regs[static_cast<size_t>(afe) * kAfeBytes + group * kRegBytes], rec, kRegBytes);
+        ++counters.regWrites;
+    }
+    return static_cast<uint8_t>(std::min(dropped, 0xFF));
+}
@@ -0,0 +1,69 @@
+#ifndef EMUFIRMWAREMODEL_H
+#define EMUFIRMWAREMODEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EmuFrame.h"
+#include "EmuFrameDecoder.h"
+
+// The emulator board firmware's side of the UART protocol, without I/O.
+//
+// Bytes from the PC go in through feed(); every frame with a valid header
+// and checksum is applied to the model and echoed back unchanged (the
+// board acknowledges each command by echoing it, which is also what the
+// latency tracker and the baud rate probe rely on). Frames with a bad DPEC
+// are echoed but not stored, unframed bytes are dropped.
+//
+//   0x8001  AFE total (clamped to kMaxAfes), Data2 = 1 clears all registers
+//   0x8010  range voltage: each AFE in [start, end] of the selected group
+//           gets all three codes = start + (afe - startIndex) * step
+//   0x8020  SPI mode
+//   0x8030  burst: every record with a good DPEC is stored, the header is
+//           acknowledged with length 0 and the number of dropped records
+//   RDCVx / RDAUXx / RDCFGx  6 register bytes of one AFE
+class EmuFirmwareModel
+{
+public:
+    static constexpr int kMaxAfes = APP_AFECASE_NUM_MAX;
+
+    struct Stats
+    {
+        uint64_t frames = 0;            // applied and echoed
+        uint64_t regWrites = 0;         // single frames and burst records
+        uint64_t bursts = 0;
+        uint64_t controlFrames = 0;
+        uint64_t dpecErrors = 0;        // echoed (burst: acknowledged), not stored
+        uint64_t unknownCommands = 0;   // echoed, ignored
+        uint64_t droppedBytes = 0;      // bad header / checksum
+    };
+
+    EmuFirmwareModel();
+
+    // Appends one response frame per complete command frame; returns the
+    // number appended
+    size_t feed(const uint8_t *data, size_t size, std::vector<EmuFrame::Frame> &responses);
+
+    void reset();
+
+    int afeTotal() const { return total; }
+    uint8_t spiMode() const { return mode; }
+    const uint8_t *registers(int afe, int group) const;   // 6 bytes, nullptr when out of range
+    const Stats &stats() const { return counters; }
+
+    // 0x8010 cmdType -> index in EmuFrame::kRegGroups, -1 when unknown
+    static int rangeGroup(uint8_t cmdType);
+
+private:
+    void apply(const uint8_t *frame);
+    uint8_t applyBurst(const uint8_t *frame);   // returns the dropped records
+
+    EmuFrameDecoder decoder;
+    int total = 1;
+    uint8_t mode = 0;
+    std::vector<uint8_t> regs;      // [afe][group][6]
+    Stats counters;
+};
+
+#endif // EMUFIRMWAREMODEL_H
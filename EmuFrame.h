@@ -0,0 +1,418 @@
+#ifndef EMUFRAME_H
+#define EMUFRAME_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "EmuProtocol.h"
+#include "LibCrcTables.h"
+
+// Stand-alone codec for the 16 bytes PC <-> emulator board frames.
+//
+//   [55 AA][CMD1 CMD2 CMD3 CMD4][AFE index][Data1 ~ Data8][Checksum]
+//
+// AFE indexes are 16 bits: the low byte is the AFE index byte, the high
+// byte goes into CMD2 (0 for the first 256 AFEs, so those frames are the
+// same as with the original single byte index).
+//
+// 0x8030 burst frames are the one exception to the fixed size: a 16 bytes
+// header followed by a payload of register records (see encodeBurst).
+//
+// Frames are plain std::array values built by constexpr encoders, one per
+// command. For every command the sum of the constant bytes (header and
+// CMD1~4) is folded at compile time, so an encoder only adds the variable
+// bytes to finish the checksum. No Qt, so the GUI and console tools share it.
+namespace EmuFrame {
+
+using Frame = std::array<uint8_t, APP_EMU_UART_PACKET_LEN>;
+
+constexpr int kRegDataLen = APP_EMU_REG_DATA_LEN;
+
+/* Constant part -----------------------------------------------------------*/
+// CMD1 is always zero, CMD2 only carries the AFE index high byte, the 16-bit
+// command sits in CMD3(high)/CMD4(low)
+constexpr uint8_t prefixSum(uint16_t cmd)
+{
+    return static_cast<uint8_t>(APP_EMU_UART_HAED1 + APP_EMU_UART_HAED2 + (cmd >> 8) + (cmd & 0xFF));
+}
+
+constexpr Frame prefix(uint16_t cmd)
+{
+    Frame f{};
+    f[APP_EMU_A_HEAD1] = APP_EMU_UART_HAED1;
+    f[APP_EMU_A_HEAD2] = APP_EMU_UART_HAED2;
+    f[APP_EMU_A_CMD3] = static_cast<uint8_t>(cmd >> 8);
+    f[APP_EMU_A_CMD4] = static_cast<uint8_t>(cmd & 0xFF);
+    return f;
+}
+
+// Finish a frame whose constant bytes sum to kPrefixSum
+template <uint8_t kPrefixSum>
+constexpr void seal(Frame &f)
+{
+    uint8_t sum = static_cast<uint8_t>(kPrefixSum + f[APP_EMU_A_AFEINDEX_HI]);
+    for (int i = APP_EMU_A_AFEINDEX; i < APP_EMU_A_CHECKSUM; ++i)
+        sum = static_cast<uint8_t>(sum + f[static_cast<size_t>(i)]);
+    f[APP_EMU_A_CHECKSUM] = sum;
+}
+
+constexpr uint8_t checksum(const uint8_t *frame)
+{
+    uint8_t sum = 0;
+    for (int i = 0; i < APP_EMU_A_CHECKSUM; ++i)
+        sum = static_cast<uint8_t>(sum + frame[i]);
+    return sum;
+}
+
+/* Register group frames (RDCVx / RDAUXx / RDCFGx) -------------------------*/
+constexpr bool isRegGroupCmd(uint16_t cmd)
+{
+    switch (cmd) {
+    case SPI_CMD_RDCVA: case SPI_CMD_RDCVB: case SPI_CMD_RDCVC:
+    case SPI_CMD_RDCVD: case SPI_CMD_RDCVE: case SPI_CMD_RDCVF:
+    case SPI_CMD_RDAUXA: case SPI_CMD_RDAUXB: case SPI_CMD_RDAUXC:
+    case SPI_CMD_RDAUXD: case SPI_CMD_RDAUXE:
+    case SPI_CMD_RDCFGA: case SPI_CMD_RDCFGB:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// data: 6 register bytes (little endian codes). A wrong PEC is produced by
+// flipping the DPEC low byte, as the GUI "Incorrect PEC" option does.
+template <uint16_t kCmd>
+constexpr Frame encodeRegGroup(uint16_t afeIndex, const uint8_t *data, bool correctPec = true)
+{
+    static_assert(isRegGroupCmd(kCmd), "not a register group read command");
+    constexpr Frame kPrefix = prefix(kCmd);
+    constexpr uint8_t kSum = prefixSum(kCmd);
+
+    Frame f = kPrefix;
+    f[APP_EMU_A_AFEINDEX] = static_cast<uint8_t>(afeIndex & 0xFF);
+    f[APP_EMU_A_AFEINDEX_HI] = static_cast<uint8_t>(afeIndex >> 8);
+    for (int i = 0; i < kRegDataLen; ++i)
+        f[static_cast<size_t>(APP_EMU_A_DATA + i)] = data[i];
+
+    const uint16_t crc = LibCrcTables::pec10Const(data, kRegDataLen, true, 0);
+    f[APP_EMU_A_DPEC1] = static_cast<uint8_t>(crc >> 8);
+    f[APP_EMU_A_DPEC2] = static_cast<uint8_t>(crc & 0xFF);
+    if (!correctPec)
+        f[APP_EMU_A_DPEC2] ^= 0xFF;
+
+    seal<kSum>(f);
+    return f;
+}
+
+// Convenience: three cell codes instead of raw bytes
+template <uint16_t kCmd>
+constexpr Frame encodeRegCodes(uint16_t afeIndex, uint16_t c1, uint16_t c2, uint16_t c3, bool correctPec = true)
+{
+    const uint8_t data[kRegDataLen] = {
+        static_cast<uint8_t>(c1 & 0xFF), static_cast<uint8_t>(c1 >> 8),
+        static_cast<uint8_t>(c2 & 0xFF), static_cast<uint8_t>(c2 >> 8),
+        static_cast<uint8_t>(c3 & 0xFF), static_cast<uint8_t>(c3 >> 8)};
+    return encodeRegGroup<kCmd>(afeIndex, data, correctPec);
+}
+
+using RegGroupEncoder = Frame (*)(uint16_t, const uint8_t *, bool);
+
+struct RegGroupInfo
+{
+    const char *name;
+    uint16_t cmd;
+    RegGroupEncoder encode;
+};
+
+// Same order as the GUI command list (RDCVA..F, RDAUXA..E, RDCFGA/B)
+constexpr RegGroupInfo kRegGroups[] = {
+    {"RDCVA",  SPI_CMD_RDCVA,  &encodeRegGroup<SPI_CMD_RDCVA>},
+    {"RDCVB",  SPI_CMD_RDCVB,  &encodeRegGroup<SPI_CMD_RDCVB>},
+    {"RDCVC",  SPI_CMD_RDCVC,  &encodeRegGroup<SPI_CMD_RDCVC>},
+    {"RDCVD",  SPI_CMD_RDCVD,  &encodeRegGroup<SPI_CMD_RDCVD>},
+    {"RDCVE",  SPI_CMD_RDCVE,  &encodeRegGroup<SPI_CMD_RDCVE>},
+    {"RDCVF",  SPI_CMD_RDCVF,  &encodeRegGroup<SPI_CMD_RDCVF>},
+    {"RDAUXA", SPI_CMD_RDAUXA, &encodeRegGroup<SPI_CMD_RDAUXA>},
+    {"RDAUXB", SPI_CMD_RDAUXB, &encodeRegGroup<SPI_CMD_RDAUXB>},
+    {"RDAUXC", SPI_CMD_RDAUXC, &encodeRegGroup<SPI_CMD_RDAUXC>},
+    {"RDAUXD", SPI_CMD_RDAUXD, &encodeRegGroup<SPI_CMD_RDAUXD>},
+    {"RDAUXE", SPI_CMD_RDAUXE, &encodeRegGroup<SPI_CMD_RDAUXE>},
+    {"RDCFGA", SPI_CMD_RDCFGA, &encodeRegGroup<SPI_CMD_RDCFGA>},
+    {"RDCFGB", SPI_CMD_RDCFGB, &encodeRegGroup<SPI_CMD_RDCFGB>},
+};
+constexpr int kRegGroupCount = static_cast<int>(sizeof(kRegGroups) / sizeof(kRegGroups[0]));
+
+// Runtime command -> encoder, nullptr for unknown commands
+constexpr RegGroupEncoder regGroupEncoder(uint16_t cmd)
+{
+    for (const RegGroupInfo &info : kRegGroups)
+        if (info.cmd == cmd)
+            return info.encode;
+    return nullptr;
+}
+
+// Runtime command -> index in kRegGroups, -1 for unknown commands
+constexpr int regGroupIndex(uint16_t cmd)
+{
+    for (int g = 0; g < kRegGroupCount; ++g)
+        if (kRegGroups[g].cmd == cmd)
+            return g;
+    return -1;
+}
+
+// Display name of a command, nullptr when unknown
+constexpr const char *commandName(uint16_t cmd)
+{
+    for (const RegGroupInfo &info : kRegGroups)
+        if (info.cmd == cmd)
+            return info.name;
+    switch (cmd) {
+    case APP_CMD_AFE_NUM:     return "AFE_NUM";
+    case APP_CMD_AFE_V_INC:   return "AFE_V_INC";
+    case APP_CMD_AFE_SPIMODE: return "AFE_SPIMODE";
+    case APP_CMD_AFE_BURST:   return "AFE_BURST";
+    default:                  return nullptr;
+    }
+}
+
+/* Control frames ----------------------------------------------------------*/
+// 0x8001: AFE total count, Data2 = 1 to (re)initialize the devices,
+// Data3 = count bits 15:8
+constexpr Frame encodeAfeTotal(uint16_t total, bool initDevice)
+{
+    constexpr Frame kPrefix = prefix(APP_CMD_AFE_NUM);
+    Frame f = kPrefix;
+    f[APP_EMU_A_DATA] = static_cast<uint8_t>(total & 0xFF);
+    f[APP_EMU_A_DATA + 1] = initDevice ? 0x01 : 0x00;
+    f[APP_EMU_A_DATA + 2] = static_cast<uint8_t>(total >> 8);
+    seal<prefixSum(APP_CMD_AFE_NUM)>(f);
+    return f;
+}
+
+// 0x8010: linear voltage ramp over an AFE range.
+// cmdType selects the register group (0x01~0x06 RDCVx, 0x11~0x15 RDAUXx,
+// 0x20/0x21 RDCFGx); start/step are sent big endian. Indexes are 12 bits:
+// Data2/Data3 hold bits 7:0, Data8 bits 11:8 (start high nibble, end low).
+constexpr Frame encodeRangeVoltage(uint8_t cmdType, uint16_t startIndex, uint16_t endIndex,
+                                   uint16_t start, uint16_t step)
+{
+    constexpr Frame kPrefix = prefix(APP_CMD_AFE_V_INC);
+    Frame f = kPrefix;
+    f[APP_EMU_A_DATA] = cmdType;
+    f[APP_EMU_A_DATA + 1] = static_cast<uint8_t>(startIndex & 0xFF);
+    f[APP_EMU_A_DATA + 2] = static_cast<uint8_t>(endIndex & 0xFF);
+    f[APP_EMU_A_DATA + 3] = static_cast<uint8_t>(start >> 8);
+    f[APP_EMU_A_DATA + 4] = static_cast<uint8_t>(start & 0xFF);
+    f[APP_EMU_A_DATA + 5] = static_cast<uint8_t>(step >> 8);
+    f[APP_EMU_A_DATA + 6] = static_cast<uint8_t>(step & 0xFF);
+    f[APP_EMU_A_DATA + 7] = static_cast<uint8_t>(((startIndex >> 4) & 0xF0) | ((endIndex >> 8) & 0x0F));
+    seal<prefixSum(APP_CMD_AFE_V_INC)>(f);
+    return f;
+}
+
+// 0x8020: SPI mode 0~3
+constexpr Frame encodeSpiMode(uint8_t mode)
+{
+    constexpr Frame kPrefix = prefix(APP_CMD_AFE_SPIMODE);
+    Frame f = kPrefix;
+    f[APP_EMU_A_DATA] = mode;
+    seal<prefixSum(APP_CMD_AFE_SPIMODE)>(f);
+    return f;
+}
+
+/* Burst frames (0x8030) ---------------------------------------------------*/
+// One transfer writes a contiguous range of register groups for a contiguous
+// range of AFEs. Header (a regular frame, covered by its checksum):
+//   AFE index (+ CMD2)  first AFE
+//   Data1               first group (index in kRegGroups)
+//   Data2               group count
+//   Data3/Data4         AFE count, big endian
+//   Data5/Data6         payload length in bytes, big endian
+//   Data7               payload checksum (additive, like the header's)
+// The payload follows directly: for each AFE, for each group one record of
+// the 6 register bytes + DPEC1/DPEC2, i.e. bytes 7~14 of the equivalent
+// 16 bytes frame, so a register write costs 8 bytes on the wire instead of 16.
+//
+// The board acknowledges with the header only: length 0 (so the ack is an
+// ordinary 16 bytes frame) and Data7 = records dropped for a bad DPEC.
+constexpr int kBurstRecordLen = APP_EMU_BURST_RECORD_LEN;
+constexpr int kBurstMaxRecords = APP_EMU_BURST_MAX_LEN / kBurstRecordLen;
+
+constexpr bool isBurst(const uint8_t *frame)
+{
+    return frame[APP_EMU_A_CMD3] == (APP_CMD_AFE_BURST >> 8) && frame[APP_EMU_A_CMD4] == (APP_CMD_AFE_BURST & 0xFF);
+}
+
+// Payload bytes announced by a header, 0 for every other frame
+constexpr int burstPayloadLen(const uint8_t *frame)
+{
+    return isBurst(frame) ? ((frame[APP_EMU_A_BURST_LEN] << 8) | frame[APP_EMU_A_BURST_LEN + 1]) : 0;
+}
+
+// Header fields consistent with each other and with the protocol limits
+constexpr bool burstHeaderOk(const uint8_t *frame)
+{
+    const int firstGroup = frame[APP_EMU_A_DATA];
+    const int groups = frame[APP_EMU_A_DATA + 1];
+    const int afes = (frame[APP_EMU_A_DATA + 2] << 8) | frame[APP_EMU_A_DATA + 3];
+    const int len = burstPayloadLen(frame);
+    return len <= APP_EMU_BURST_MAX_LEN && groups >= 1 && firstGroup + groups <= kRegGroupCount &&
+           (len == 0 || len == afes * groups * kBurstRecordLen);
+}
+
+constexpr uint8_t burstPayloadSum(const uint8_t *payload, int len)
+{
+    uint8_t sum = 0;
+    for (int i = 0; i < len; ++i)
+        sum = static_cast<uint8_t>(sum + payload[i]);
+    return sum;
+}
+
+// DPEC of one payload record (DPEC1 also carries the command counter)
+constexpr bool burstRecordOk(const uint8_t *record)
+{
+    const uint16_t rx = static_cast<uint16_t>(((record[kRegDataLen] & 0x03) << 8) | record[kRegDataLen + 1]);
+    return LibCrcTables::pec10Const(record, kRegDataLen, true, record[kRegDataLen]) == rx;
+}
+
+// Header of a payload that is already assembled (len bytes of records)
+inline Frame encodeBurstHeader(uint16_t firstAfe, uint16_t afeCount, int firstGroup, int groupCount,
+                               const uint8_t *payload, int len)
+{
+    Frame f = prefix(APP_CMD_AFE_BURST);
+    f[APP_EMU_A_AFEINDEX] = static_cast<uint8_t>(firstAfe & 0xFF);
+    f[APP_EMU_A_AFEINDEX_HI] = static_cast<uint8_t>(firstAfe >> 8);
+    f[APP_EMU_A_DATA] = static_cast<uint8_t>(firstGroup);
+    f[APP_EMU_A_DATA + 1] = static_cast<uint8_t>(groupCount);
+    f[APP_EMU_A_DATA + 2] = static_cast<uint8_t>(afeCount >> 8);
+    f[APP_EMU_A_DATA + 3] = static_cast<uint8_t>(afeCount & 0xFF);
+    f[APP_EMU_A_BURST_LEN] = static_cast<uint8_t>(len >> 8);
+    f[APP_EMU_A_BURST_LEN + 1] = static_cast<uint8_t>(len & 0xFF);
+    f[APP_EMU_A_DATA + 6] = burstPayloadSum(payload, len);
+    seal<prefixSum(APP_CMD_AFE_BURST)>(f);
+    return f;
+}
+
+// regData: afeCount * groupCount * 6 register bytes in payload order.
+// out must hold 16 + afeCount * groupCount * 8 bytes; returns the bytes
+// written, 0 when the ranges do not fit in one burst.
+inline size_t encodeBurst(uint16_t firstAfe, uint16_t afeCount, int firstGroup, int groupCount,
+                          const uint8_t *regData, uint8_t *out, bool correctPec = true)
+{
+    const int records = afeCount * groupCount;
+    if (afeCount == 0 || groupCount < 1 || firstGroup < 0 || firstGroup + groupCount > kRegGroupCount ||
+        records > kBurstMaxRecords)
+        return 0;
+
+    uint8_t *payload = out + APP_EMU_UART_PACKET_LEN;
+    for (int r = 0; r < records; ++r) {
+        uint8_t *rec = payload + r * kBurstRecordLen;
+        std::memcpy(rec, regData + r * kRegDataLen, kRegDataLen);
+        const uint16_t crc = LibCrcTables::pec10Const(rec, kRegDataLen, true, 0);
+        rec[kRegDataLen] = static_cast<uint8_t>(crc >> 8);
+        rec[kRegDataLen + 1] = static_cast<uint8_t>(crc & 0xFF);
+        if (!correctPec)
+            rec[kRegDataLen + 1] ^= 0xFF;
+    }
+    const int len = records * kBurstRecordLen;
+
+    const Frame f = encodeBurstHeader(firstAfe, afeCount, firstGroup, groupCount, payload, len);
+    std::memcpy(out, f.data(), f.size());
+    return APP_EMU_UART_PACKET_LEN + static_cast<size_t>(len);
+}
+
+// Board side acknowledgement of a burst header
+constexpr Frame encodeBurstAck(const uint8_t *header, uint8_t droppedRecords)
+{
+    Frame f = prefix(APP_CMD_AFE_BURST);
+    f[APP_EMU_A_AFEINDEX] = header[APP_EMU_A_AFEINDEX];
+    f[APP_EMU_A_AFEINDEX_HI] = header[APP_EMU_A_AFEINDEX_HI];
+    for (int i = 0; i < 4; ++i)
+        f[static_cast<size_t>(APP_EMU_A_DATA + i)] = header[APP_EMU_A_DATA + i];
+    f[APP_EMU_A_DATA + 6] = droppedRecords;
+    seal<prefixSum(APP_CMD_AFE_BURST)>(f);
+    return f;
+}
+
+/* Decoder -----------------------------------------------------------------*/
+enum class Status : uint8_t
+{
+    Ok,
+    BadHeader,
+    BadChecksum,
+    BadDpec         // header/checksum fine, register group DPEC wrong
+};
+
+struct Decoded
+{
+    uint16_t cmd = 0;
+    uint16_t afeIndex = 0;      // CMD2 << 8 | AFE index byte
+    uint8_t data[APP_EMU_UART_DATA_LEN] = {};   // Data1 ~ Data8
+    bool isRegGroup = false;
+    uint16_t dpec = 0;          // received DPEC bits 9:0
+    uint8_t cmdCounter = 0;     // upper 6 bits of the DPEC high byte
+
+    // Register group helpers
+    constexpr uint16_t code(int i) const
+    {
+        return static_cast<uint16_t>(data[2 * i] | (data[2 * i + 1] << 8));
+    }
+
+    // Control frame helpers
+    constexpr uint16_t afeTotal() const { return static_cast<uint16_t>(data[0] | (data[2] << 8)); }
+    constexpr bool initDevice() const { return data[1] != 0; }
+    constexpr uint8_t rangeCmdType() const { return data[0]; }
+    constexpr uint16_t rangeStartIndex() const { return static_cast<uint16_t>(data[1] | ((data[7] & 0xF0) << 4)); }
+    constexpr uint16_t rangeEndIndex() const { return static_cast<uint16_t>(data[2] | ((data[7] & 0x0F) << 8)); }
+    constexpr uint16_t rangeStart() const { return static_cast<uint16_t>((data[3] << 8) | data[4]); }
+    constexpr uint16_t rangeStep() const { return static_cast<uint16_t>((data[5] << 8) | data[6]); }
+    constexpr uint8_t spiMode() const { return data[0]; }
+    constexpr uint8_t burstFirstGroup() const { return data[0]; }
+    constexpr uint8_t burstGroupCount() const { return data[1]; }
+    constexpr uint16_t burstAfeCount() const { return static_cast<uint16_t>((data[2] << 8) | data[3]); }
+    constexpr uint16_t burstLength() const { return static_cast<uint16_t>((data[4] << 8) | data[5]); }
+    constexpr uint8_t burstDropped() const { return data[6]; }   // acknowledgement only
+};
+
+constexpr Status decode(const uint8_t *frame, Decoded &out)
+{
+    if (frame[APP_EMU_A_HEAD1] != APP_EMU_UART_HAED1 || frame[APP_EMU_A_HEAD2] != APP_EMU_UART_HAED2)
+        return Status::BadHeader;
+    if (checksum(frame) != frame[APP_EMU_A_CHECKSUM])
+        return Status::BadChecksum;
+
+    out.cmd = static_cast<uint16_t>((frame[APP_EMU_A_CMD3] << 8) | frame[APP_EMU_A_CMD4]);
+    out.afeIndex = static_cast<uint16_t>(frame[APP_EMU_A_AFEINDEX] | (frame[APP_EMU_A_AFEINDEX_HI] << 8));
+    for (int i = 0; i < APP_EMU_UART_DATA_LEN; ++i)
+        out.data[i] = frame[APP_EMU_A_DATA + i];
+    out.isRegGroup = (out.cmd & APP_CMD_MASK) == 0;
+    if (!out.isRegGroup)
+        return Status::Ok;
+
+    out.dpec = static_cast<uint16_t>(((frame[APP_EMU_A_DPEC1] & 0x03) << 8) | frame[APP_EMU_A_DPEC2]);
+    out.cmdCounter = static_cast<uint8_t>(frame[APP_EMU_A_DPEC1] >> 2);
+    const uint16_t crc = LibCrcTables::pec10Const(&frame[APP_EMU_A_DATA], kRegDataLen, true, frame[APP_EMU_A_DPEC1]);
+    return crc == out.dpec ? Status::Ok : Status::BadDpec;
+}
+
+inline Status decode(const Frame &frame, Decoded &out) { return decode(frame.data(), out); }
+
+/* Compile-time self checks ------------------------------------------------*/
+static_assert(prefixSum(SPI_CMD_RDCVA) == 0x03, "RDCVA prefix sum");
+
+namespace detail {
+constexpr uint8_t kExampleData[kRegDataLen] = {0x00, 0x80, 0x00, 0x80, 0x00, 0x80};
+constexpr Frame kExampleFrame = encodeRegGroup<SPI_CMD_RDCVA>(0, kExampleData);
+} // namespace detail
+
+static_assert(detail::kExampleFrame[APP_EMU_A_DPEC1] == 0x02 && detail::kExampleFrame[APP_EMU_A_DPEC2] == 0xCE,
+              "RDCVA example DPEC");
+static_assert(detail::kExampleFrame[APP_EMU_A_CHECKSUM] == 0x53, "RDCVA example checksum");
+static_assert(encodeRegGroup<SPI_CMD_RDCVA>(0x0100, detail::kExampleData)[APP_EMU_A_CHECKSUM] == 0x54,
+              "AFE index high byte is part of the checksum");
+
+} // namespace EmuFrame
+
+#endif // EMUFRAME_H
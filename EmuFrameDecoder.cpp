@@ -0,0 +1,222 @@
+#include "EmuFrameDecoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "EmuFrame.h"
+#include "LibCrc15Crc10TableCalc.h"
+#include "LibPecBatchCalc.h"
+
+namespace {
+
+int badBurstRecords(const uint8_t *payload, int records)
+{
+    // DPEC1 follows the data of each record, as the batch CRC expects
+    uint16_t crc[EmuFrame::kBurstMaxRecords];
+    pec10_calc_batch(true, APP_EMU_REG_DATA_LEN, payload, EmuFrame::kBurstRecordLen, static_cast<size_t>(records), crc);
+    int bad = 0;
+    for (int r = 0; r < records; ++r) {
+        const uint8_t *rec = payload + r * EmuFrame::kBurstRecordLen;
+        const uint16_t rx = static_cast<uint16_t>(((rec[APP_EMU_REG_DATA_LEN] & 0x03) << 8) | rec[APP_EMU_REG_DATA_LEN + 1]);
+        bad += (crc[r] != rx);
+    }
+    return bad;
+}
+
+} // namespace
+
+EmuFrameDecoder::EmuFrameDecoder(size_t capacityPow2)
+{
+    size_t capacity = 64;
+    while (capacity < capacityPow2 || capacity < APP_EMU_BURST_FRAME_MAX)
+        capacity <<= 1;
+    ring.assign(capacity + kMirror, 0);
+    mask = capacity - 1;
+}
+
+void EmuFrameDecoder::reset()
+{
+    head = tail = 0;
+    hunting = false;
+    burstWait = 0;
+    counters = Stats();
+}
+
+uint8_t *EmuFrameDecoder::writeBuffer(size_t &room)
+{
+    const size_t capacity = mask + 1;
+    const size_t offset = head & mask;
+    room = std::min(capacity - (head - tail), capacity - offset);
+    return &ring[offset];
+}
+
+void EmuFrameDecoder::commit(size_t n)
+{
+    mirror(head, n);
+    head += n;
+}
+
+size_t EmuFrameDecoder::write(const uint8_t *p, size_t n)
+{
+    size_t done = 0;
+    while (done < n) {
+        size_t room = 0;
+        uint8_t *dst = writeBuffer(room);
+        if (room == 0)
+            break;
+        const size_t chunk = std::min(room, n - done);
+        std::memcpy(dst, p + done, chunk);
+        commit(chunk);
+        done += chunk;
+    }
+    return done;
+}
+
+// Bytes landing in [0, kMirror) are duplicated at [capacity, capacity + kMirror).
+// commit() chunks come from writeBuffer() and never cross the end of the ring.
+void EmuFrameDecoder::mirror(size_t from, size_t n)
+{
+    const size_t begin = from & mask;
+    if (begin >= kMirror)
+        return;
+    const size_t end = std::min(begin + n, kMirror);
+    std::memcpy(&ring[mask + 1 + begin], &ring[begin], end - begin);
+}
+
+bool EmuFrameDecoder::checksumOk(const uint8_t *frame)
+{
+    return EmuProtocol_Checksum(frame) == frame[APP_EMU_A_CHECKSUM];
+}
+
+bool EmuFrameDecoder::isRegisterGroup(const uint8_t *frame)
+{
+    const uint16_t cmd = static_cast<uint16_t>((frame[APP_EMU_A_CMD3] << 8) | frame[APP_EMU_A_CMD4]);
+    return (cmd & APP_CMD_MASK) == 0;
+}
+
+bool EmuFrameDecoder::emitGarbage(Item &item, size_t n)
+{
+    // The view may not cross the end of the ring (only kMirror bytes are mirrored)
+    const size_t offset = tail & mask;
+    const size_t contiguous = mask + 1 + kMirror - offset;
+    n = std::min(n, contiguous);
+
+    item.kind = Item::Garbage;
+    item.data = viewAt(tail);
+    item.size = static_cast<int>(n);
+    item.hasDpec = false;
+    item.dpecOk = false;
+
+    counters.garbageBytes += n;
+    tail += n;
+    hunting = true;
+    return true;
+}
+
+bool EmuFrameDecoder::next(Item &item)
+{
+    size_t skip = 0;
+    burstWait = 0;
+
+    for (;;) {
+        const size_t at = tail + skip;
+        const size_t avail = head - at;
+        if (avail == 0)
+            break;
+
+        // Header hunt
+        if (byteAt(at) != APP_EMU_UART_HAED1) {
+            ++skip;
+            continue;
+        }
+        if (avail < 2)
+            break;
+        if (byteAt(at + 1) != APP_EMU_UART_HAED2) {
+            ++skip;
+            continue;
+        }
+        if (avail < APP_EMU_UART_PACKET_LEN)
+            break;
+
+        const uint8_t *frame = viewAt(at);
+        if (!checksumOk(frame)) {
+            ++counters.checksumErrors;
+            ++skip;
+            continue;
+        }
+
+        // Burst: wait for the whole payload, a bad length or payload sum
+        // counts as a checksum error of the header
+        const int payload = EmuFrame::burstPayloadLen(frame);
+        if (EmuFrame::isBurst(frame)) {
+            if (!EmuFrame::burstHeaderOk(frame)) {
+                ++counters.checksumErrors;
+                ++skip;
+                continue;
+            }
+            if (avail < APP_EMU_UART_PACKET_LEN + static_cast<size_t>(payload)) {
+                burstWait = static_cast<size_t>(payload);
+                break;
+            }
+            if (EmuFrame::burstPayloadSum(frame + APP_EMU_UART_PACKET_LEN, payload) != frame[APP_EMU_A_DATA + 6]) {
+                ++counters.checksumErrors;
+                ++skip;
+                continue;
+            }
+        }
+
+        // Valid frame: hand out anything skipped in front of it first
+        if (skip > 0)
+            return emitGarbage(item, skip);
+
+        item.kind = Item::Frame;
+        item.data = frame;
+        item.size = APP_EMU_UART_PACKET_LEN + payload;
+        item.hasDpec = isRegisterGroup(frame);
+        item.dpecOk = true;
+        if (payload > 0) {
+            const int bad = badBurstRecords(frame + APP_EMU_UART_PACKET_LEN, payload / EmuFrame::kBurstRecordLen);
+            item.hasDpec = true;
+            item.dpecOk = (bad == 0);
+            counters.dpecErrors += static_cast<uint64_t>(bad);
+            ++counters.bursts;
+        } else if (item.hasDpec) {
+            // DPEC high byte carries the 6-bit command counter above PEC bits 9:8
+            uint8_t *data = const_cast<uint8_t *>(frame + APP_EMU_A_DATA);
+            const uint16_t crc = pec10_calc(true, APP_EMU_REG_DATA_LEN, data);
+            const uint16_t rx = static_cast<uint16_t>(((frame[APP_EMU_A_DPEC1] & 0x03) << 8) | frame[APP_EMU_A_DPEC2]);
+            item.dpecOk = (crc == rx);
+            if (!item.dpecOk)
+                ++counters.dpecErrors;
+        }
+
+        if (hunting) {
+            ++counters.resyncs;
+            hunting = false;
+        }
+        ++counters.frames;
+        tail += static_cast<size_t>(item.size);
+        return true;
+    }
+
+    if (skip > 0)
+        return emitGarbage(item, skip);
+    return false;
+}
+
+size_t EmuFrameDecoder::drain(uint8_t *out, size_t maxLen)
+{
+    size_t n = std::min(pending(), maxLen);
+    for (size_t i = 0; i < n; ++i)
+        out[i] = byteAt(tail + i);
+    tail += n;
+    burstWait = 0;
+    return n;
+}
+
+uint64_t EmuFrameDecoder::holdLimitNs(uint64_t baseNs, uint32_t bytesPerSec) const
+{
+    if (burstWait == 0 || bytesPerSec == 0)
+        return baseNs;
+    return baseNs + static_cast<uint64_t>(burstWait) * 1000000000ull / bytesPerSec;
+}
@@ -0,0 +1,92 @@
+#ifndef EMUFRAMEDECODER_H
+#define EMUFRAMEDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EmuProtocol.h"
+
+// Resynchronizing RX frame decoder for the emulator UART stream.
+//
+// Bytes are written straight into a power-of-two ring (writeBuffer/commit),
+// the decoder hunts for the 55 AA header, validates the additive checksum and
+// (for register group frames) the DPEC, and hands out views into the ring.
+// 0x8030 burst frames are handed out whole (header + payload) once the
+// announced payload has arrived and its checksum matches.
+// The first APP_EMU_BURST_FRAME_MAX-1 bytes of the ring are mirrored behind
+// its end, so every frame view is contiguous and nothing is copied.
+//
+// A view stays valid until the next call to next(), commit() or drain().
+class EmuFrameDecoder
+{
+public:
+    struct Item
+    {
+        enum Kind { Frame, Garbage };
+
+        Kind kind;
+        const uint8_t *data;
+        int size;
+        bool hasDpec;      // register group frame (RDCVx/RDAUXx/RDCFGx) or burst with payload
+        bool dpecOk;       // burst: every record
+    };
+
+    struct Stats
+    {
+        uint64_t frames = 0;
+        uint64_t checksumErrors = 0;
+        uint64_t dpecErrors = 0;       // frames / burst records
+        uint64_t bursts = 0;
+        uint64_t resyncs = 0;          // header hunts that ended on a valid frame
+        uint64_t garbageBytes = 0;     // bytes skipped while hunting
+    };
+
+    explicit EmuFrameDecoder(size_t capacityPow2 = 64 * 1024);
+
+    // Zero-copy fill: returns contiguous free space, then commit() what was written.
+    uint8_t *writeBuffer(size_t &room);
+    void commit(size_t n);
+
+    // Copying fill, returns number of bytes accepted (less than n when full).
+    size_t write(const uint8_t *p, size_t n);
+
+    // Next frame or run of skipped garbage bytes; false when more input is needed.
+    bool next(Item &item);
+
+    // Bytes received but not yet handed out (an incomplete frame).
+    size_t pending() const { return head - tail; }
+
+    // Copy out and discard the pending bytes (partial frame flush).
+    size_t drain(uint8_t *out, size_t maxLen);
+
+    // How long the pending bytes may be held before they are flushed:
+    // baseNs, plus the wire time of the payload of a checked burst header
+    // next() is waiting on (up to 2 KiB, ~180 ms at 115200 baud).
+    uint64_t holdLimitNs(uint64_t baseNs, uint32_t bytesPerSec) const;
+
+    void reset();
+
+    const Stats &stats() const { return counters; }
+
+    static bool checksumOk(const uint8_t *frame);
+    static bool isRegisterGroup(const uint8_t *frame);
+
+private:
+    static constexpr size_t kMirror = APP_EMU_BURST_FRAME_MAX - 1;
+
+    uint8_t byteAt(size_t pos) const { return ring[pos & mask]; }
+    const uint8_t *viewAt(size_t pos) const { return &ring[pos & mask]; }
+    void mirror(size_t from, size_t n);
+    bool emitGarbage(Item &item, size_t n);
+
+    std::vector<uint8_t> ring;
+    size_t mask;
+    size_t head = 0;       // monotonic write position
+    size_t tail = 0;       // monotonic read position
+    bool hunting = false;
+    size_t burstWait = 0;  // payload bytes of the burst header next() stopped at
+    Stats counters;
+};
+
+#endif // EMUFRAMEDECODER_H
@@ -0,0 +1,17 @@
+#include "EmuLog.h"
+
+#include "HexFormat.h"
+
+Q_LOGGING_CATEGORY(lcEmuTraffic, "emu.traffic", QtInfoMsg)
+
+void EmuLog_Traffic(const char *tag, const uint8_t *data, int size)
+{
+    if (!lcEmuTraffic().isDebugEnabled() || size <= 0)
+        return;
+
+    char hexStr[HexFormat::bufferSize(256)];
+    if (size > 256)
+        size = 256;
+    HexFormat::format(data, static_cast<size_t>(size), hexStr);
+    qCDebug(lcEmuTraffic, "%s %s", tag, hexStr);
+}
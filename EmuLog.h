@@ -0,0 +1,17 @@
+#ifndef EMULOG_H
+#define EMULOG_H
+
+#include <QLoggingCategory>
+
+#include <cstdint>
+
+// TX/RX hex dumps go to the "emu.traffic" category, which is off by default.
+// Turn it on from the environment, for the GUI and headless alike:
+//   QT_LOGGING_RULES="emu.traffic.debug=true"
+// (or the [Rules] section of qtlogging.ini). When off, no formatting is
+// done at all.
+Q_DECLARE_LOGGING_CATEGORY(lcEmuTraffic)
+
+void EmuLog_Traffic(const char *tag, const uint8_t *data, int size);
+
+#endif // EMULOG_H
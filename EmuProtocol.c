@@ -0,0 +1,69 @@
+/*
+******************************************************************************
+* @file     EmuProtocol.c
+* @author   Golden Chen
+* @brief    PC <-> AFE emulator board UART protocol helpers
+
+******************************************************************************
+* @attention
+*
+* COPYRIGHT(c) 2025 FW Team</center>
+******************************************************************************
+*/
+
+#include "EmuProtocol.h"
+#include "LibCrc15Crc10TableCalc.h"
+
+// Cell voltage(uV) -> ADBMS6832 register code, little endian
+// Code = (V - 1.5V) / 150uV
+//-----------------------------------------------------------------------------------
+void EmuProtocol_VoltageToBytes(double voltage_uV, uint8_t *out_bytes)
+{
+    uint16_t raw = (uint16_t)((voltage_uV - 1500000.0) / 150.0);
+    out_bytes[0] = (uint8_t)(raw & 0xFF);
+    out_bytes[1] = (uint8_t)((raw >> 8) & 0xFF);
+}
+
+// Additive checksum of packet bytes B0~B14
+//-----------------------------------------------------------------------------------
+uint8_t EmuProtocol_Checksum(const uint8_t *pPacket)
+{
+    uint8_t checksum = 0;
+    for (int i = 0; i < APP_EMU_A_CHECKSUM; ++i)
+        checksum += pPacket[i];
+    return checksum;
+}
+
+// Build a 16 bytes register group packet:
+// [55 AA][CMD1~4][AFE index][Data1~6][DPEC H][DPEC L][Checksum]
+// pCmd is CMD1~CMD4 (4 bytes), pRegData is the 6 bytes register group data.
+//-----------------------------------------------------------------------------------
+void EmuProtocol_BuildRegPacket(uint8_t *pPacket, const uint8_t *pCmd, uint8_t u8AfeIndex,
+                                const uint8_t *pRegData, bool blCorrectPec)
+{
+    uint8_t data[APP_EMU_REG_DATA_LEN + 1];
+    uint16_t crc;
+    int i;
+
+    pPacket[APP_EMU_A_HEAD1] = APP_EMU_UART_HAED1;
+    pPacket[APP_EMU_A_HEAD2] = APP_EMU_UART_HAED2;
+    for (i = 0; i < 4; ++i)
+        pPacket[APP_EMU_A_CMD1 + i] = pCmd[i];
+    pPacket[APP_EMU_A_AFEINDEX] = u8AfeIndex;
+
+    for (i = 0; i < APP_EMU_REG_DATA_LEN; ++i) {
+        data[i] = pRegData[i];
+        pPacket[APP_EMU_A_DATA + i] = pRegData[i];
+    }
+    data[APP_EMU_REG_DATA_LEN] = 0;    /* command counter */
+
+    //CRC 10(DPEC) Calc
+    crc = pec10_calc(true, APP_EMU_REG_DATA_LEN, data);
+    pPacket[APP_EMU_A_DPEC1] = (uint8_t)(crc >> 8);
+    pPacket[APP_EMU_A_DPEC2] = (uint8_t)(crc & 0xFF);
+    if (!blCorrectPec)
+        pPacket[APP_EMU_A_DPEC2] ^= 0xFF;
+
+    pPacket[APP_EMU_A_CHECKSUM] = EmuProtocol_Checksum(pPacket);
+}
+//-----------------------------------------------------------------------------------
@@ -0,0 +1,100 @@
+/*
+******************************************************************************
+* @file     EmuProtocol.h
+* @author   Golden Chen
+* @brief    PC <-> AFE emulator board UART protocol definitions
+
+******************************************************************************
+* @attention
+*
+* COPYRIGHT(c) 2025 FW Team</center>
+******************************************************************************
+*/
+#ifndef __EMU_PROTOCOL_H__
+#define	__EMU_PROTOCOL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+/* Global define ------------------------------------------------------------*/
+#define SPI_CMD_RDCVA                              (0x0004)
+#define SPI_CMD_RDCVB                              (0x0006)
+#define SPI_CMD_RDCVC                              (0x0008)
+#define SPI_CMD_RDCVD                              (0x000A)
+#define SPI_CMD_RDCVE                              (0x0009)
+#define SPI_CMD_RDCVF                              (0x000B)
+
+#define SPI_CMD_RDAUXA                             (0x0019)
+#define SPI_CMD_RDAUXB                             (0x001A)
+#define SPI_CMD_RDAUXC                             (0x001B)
+#define SPI_CMD_RDAUXD                             (0x001F)
+#define SPI_CMD_RDAUXE                             (0x0036)
+
+#define SPI_CMD_WRCFGA                             (0x0001)
+#define SPI_CMD_RDCFGA                             (0x0002)
+
+#define SPI_CMD_WRCFGB                             (0x0024)
+#define SPI_CMD_RDCFGB                             (0x0026)
+
+
+#define APP_CMD_MASK                               (0x8000)
+#define APP_CMD_AFE_NUM                            (0x8001)
+#define APP_CMD_AFE_V_INC                          (0x8010)
+#define APP_CMD_AFE_SPIMODE                        (0x8020)
+#define APP_CMD_AFE_BURST                          (0x8030)
+
+#define APP_AFECASE_NUM_MAX                        (1024)  /* legacy firmware: 30 */
+
+#define APP_EMU_UART_HAED1                         (0x55)
+#define APP_EMU_UART_HAED2                         (0xAA)
+
+#define APP_EMU_A_HEAD1                             (0)
+#define APP_EMU_A_HEAD2                             (1)
+#define APP_EMU_A_CMD1                              (2)
+#define APP_EMU_A_CMD2                              (3)
+#define APP_EMU_A_CMD3                              (4)
+#define APP_EMU_A_CMD4                              (5)
+#define APP_EMU_A_AFEINDEX                          (6)
+#define APP_EMU_A_DATA                              (7)
+#define APP_EMU_A_CHECKSUM                          (15)
+
+/* AFE index bits 15:8 (chains > 256 AFEs), 0 for the first 256 AFEs so the
+   frames stay identical to the single byte index format */
+#define APP_EMU_A_AFEINDEX_HI                       (APP_EMU_A_CMD2)
+
+#define APP_EMU_UART_DATA_LEN                       (8)
+
+#define APP_EMU_UART_PACKET_LEN                     (16)
+
+#define APP_EMU_REMAIN_DATA_DELAY                   (100)   //ms, longest hold of a partial frame
+
+/* Register group payload: 6 data bytes + 2 DPEC bytes */
+#define APP_EMU_REG_DATA_LEN                        (6)
+#define APP_EMU_A_DPEC1                             (APP_EMU_A_DATA + APP_EMU_REG_DATA_LEN)
+#define APP_EMU_A_DPEC2                             (APP_EMU_A_DPEC1 + 1)
+
+/* 0x8030 burst write: the 16 bytes header frame is followed by Data5/Data6
+   (big endian) payload bytes, one record per AFE per register group */
+#define APP_EMU_BURST_RECORD_LEN                    (APP_EMU_REG_DATA_LEN + 2)  /* data + DPEC1/2 */
+#define APP_EMU_BURST_MAX_LEN                       (2048)  //payload bytes, 256 records
+#define APP_EMU_BURST_FRAME_MAX                     (APP_EMU_UART_PACKET_LEN + APP_EMU_BURST_MAX_LEN)
+#define APP_EMU_A_BURST_LEN                         (APP_EMU_A_DATA + 4)
+
+/* Global typedef -----------------------------------------------------------*/
+/* Global macro -------------------------------------------------------------*/
+/* Global function prototypes -----------------------------------------------*/
+void EmuProtocol_VoltageToBytes(double voltage_uV, uint8_t *out_bytes);
+uint8_t EmuProtocol_Checksum(const uint8_t *pPacket);
+void EmuProtocol_BuildRegPacket(uint8_t *pPacket, const uint8_t *pCmd, uint8_t u8AfeIndex,
+                                const uint8_t *pRegData, bool blCorrectPec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,283 @@
+#include "EmuPtyStandIn.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t kMaxPendingFrames = 65536;     // PC not reading: drop the oldest echoes
+constexpr int kMaxPollMs = 20;                  // stop() latency
+constexpr uint64_t kBurstNs = 2000000;          // token bucket depth: 2 ms of line time
+
+uint64_t monotonicNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void setError(std::string *error, const char *what)
+{
+    if (error)
+        *error = std::string(what) + ": " + std::strerror(errno);
+}
+
+// Bytes the virtual line may carry; unlimited when rate is 0
+class TokenBucket
+{
+public:
+    explicit TokenBucket(double bytesPerSec) : rate(bytesPerSec) {}
+
+    bool limited() const { return rate > 0.0; }
+
+    void refill(uint64_t nowNs)
+    {
+        if (!limited())
+            return;
+        if (last != 0) {
+            const double depth = std::max(rate * static_cast<double>(kBurstNs) / 1e9, 1.0 * APP_EMU_UART_PACKET_LEN);
+            tokens = std::min(depth, tokens + rate * static_cast<double>(nowNs - last) / 1e9);
+        }
+        last = nowNs;
+    }
+
+    size_t available(size_t want) const
+    {
+        return limited() ? std::min(want, static_cast<size_t>(tokens)) : want;
+    }
+
+    void take(size_t n)
+    {
+        if (limited())
+            tokens -= static_cast<double>(n);
+    }
+
+    // ns until one byte may go, 0 when one already can
+    uint64_t waitNs() const
+    {
+        if (!limited() || tokens >= 1.0)
+            return 0;
+        return static_cast<uint64_t>((1.0 - tokens) / rate * 1e9) + 1;
+    }
+
+private:
+    double rate;
+    double tokens = 0.0;
+    uint64_t last = 0;
+};
+
+} // namespace
+
+EmuPtyStandIn::~EmuPtyStandIn()
+{
+    stop();
+}
+
+std::string EmuPtyStandIn::nextFreeLinkPath()
+{
+    for (int i = 0; i < 100; ++i) {
+        const std::string path = kLinkPrefix + std::to_string(i);
+        struct stat st;
+        if (lstat(path.c_str(), &st) != 0)
+            return path;
+        // 殘留的連結 (目標已不存在) 可以重用
+        if (S_ISLNK(st.st_mode) && stat(path.c_str(), &st) != 0)
+            return path;
+    }
+    return std::string();
+}
+
+bool EmuPtyStandIn::start(const Config &config, std::string *error)
+{
+    stop();
+    cfg = config;
+    if (cfg.bitsPerChar <= 0)
+        cfg.bitsPerChar = 10;
+
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterFd < 0) {
+        setError(error, "posix_openpt");
+        return false;
+    }
+    char name[128];
+    if (grantpt(masterFd) != 0 || unlockpt(masterFd) != 0 || ptsname_r(masterFd, name, sizeof(name)) != 0) {
+        setError(error, "pty setup");
+        stop();
+        return false;
+    }
+    slave = name;
+
+    slaveFd = open(name, O_RDWR | O_NOCTTY);
+    if (slaveFd < 0) {
+        setError(error, slave.c_str());
+        stop();
+        return false;
+    }
+
+    // Raw line discipline until a client configures the port itself
+    struct termios tio;
+    if (tcgetattr(slaveFd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(slaveFd, TCSANOW, &tio);
+    }
+    fcntl(masterFd, F_SETFL, fcntl(masterFd, F_GETFL) | O_NONBLOCK);
+
+    if (!cfg.linkPath.empty()) {
+        struct stat st;
+        if (lstat(cfg.linkPath.c_str(), &st) == 0 && S_ISLNK(st.st_mode))
+            unlink(cfg.linkPath.c_str());
+        if (symlink(slave.c_str(), cfg.linkPath.c_str()) != 0) {
+            setError(error, cfg.linkPath.c_str());
+            cfg.linkPath.clear();
+            stop();
+            return false;
+        }
+    }
+
+    rxBytes = 0;
+    txBytes = 0;
+    frames = 0;
+    dpecErrors = 0;
+    droppedBytes = 0;
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&EmuPtyStandIn::run, this);
+    return true;
+}
+
+void EmuPtyStandIn::stop()
+{
+    running.store(false, std::memory_order_release);
+    if (thread.joinable())
+        thread.join();
+
+    if (!cfg.linkPath.empty()) {
+        char target[128];
+        const ssize_t n = readlink(cfg.linkPath.c_str(), target, sizeof(target) - 1);
+        if (n > 0 && slave.compare(0, std::string::npos, target, static_cast<size_t>(n)) == 0)
+            unlink(cfg.linkPath.c_str());
+    }
+    if (slaveFd >= 0)
+        close(slaveFd);
+    if (masterFd >= 0)
+        close(masterFd);
+    slaveFd = -1;
+    masterFd = -1;
+}
+
+EmuPtyStandIn::Stats EmuPtyStandIn::stats() const
+{
+    Stats s;
+    s.rxBytes = rxBytes.load(std::memory_order_relaxed);
+    s.txBytes = txBytes.load(std::memory_order_relaxed);
+    s.frames = frames.load(std::memory_order_relaxed);
+    s.dpecErrors = dpecErrors.load(std::memory_order_relaxed);
+    s.droppedBytes = droppedBytes.load(std::memory_order_relaxed);
+    return s;
+}
+
+void EmuPtyStandIn::run()
+{
+    struct Pending
+    {
+        uint64_t dueNs;
+        EmuFrame::Frame frame;
+    };
+
+    const double bytesPerSec = cfg.baudRate ? static_cast<double>(cfg.baudRate) / cfg.bitsPerChar : 0.0;
+    const uint64_t delayNs = static_cast<uint64_t>(cfg.responseDelayUs) * 1000;
+    TokenBucket rxLine(bytesPerSec);
+    TokenBucket txLine(bytesPerSec);
+    EmuFirmwareModel model;
+    std::vector<EmuFrame::Frame> responses;
+    std::deque<Pending> pending;
+    size_t sentOfFront = 0;     // bytes of pending.front() already written
+    uint8_t buf[4096];
+
+    while (running.load(std::memory_order_acquire)) {
+        uint64_t now = monotonicNs();
+        rxLine.refill(now);
+        txLine.refill(now);
+
+        // PC -> stand-in, only as fast as the virtual line
+        const size_t want = rxLine.available(sizeof(buf));
+        if (want > 0) {
+            const ssize_t n = read(masterFd, buf, want);
+            if (n > 0) {
+                rxLine.take(static_cast<size_t>(n));
+                rxBytes.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+                responses.clear();
+                model.feed(buf, static_cast<size_t>(n), responses);
+                for (const EmuFrame::Frame &f : responses) {
+                    if (pending.size() >= kMaxPendingFrames) {
+                        // 已送出一部分的封包要送完，否則 PC 端會收到被截斷的回應
+                        if (sentOfFront > 0)
+                            pending.erase(pending.begin() + 1);
+                        else
+                            pending.pop_front();
+                    }
+                    pending.push_back({now + delayNs, f});
+                }
+                const EmuFirmwareModel::Stats &ms = model.stats();
+                frames.store(ms.frames, std::memory_order_relaxed);
+                dpecErrors.store(ms.dpecErrors, std::memory_order_relaxed);
+                droppedBytes.store(ms.droppedBytes, std::memory_order_relaxed);
+            }
+        }
+
+        // Echoes that are due
+        bool blocked = false;
+        while (!pending.empty() && pending.front().dueNs <= now) {
+            const EmuFrame::Frame &f = pending.front().frame;
+            const size_t len = txLine.available(f.size() - sentOfFront);
+            if (len == 0)
+                break;
+            const ssize_t n = write(masterFd, f.data() + sentOfFront, len);
+            if (n <= 0) {
+                blocked = true;     // PC side not reading, tty buffer full
+                break;
+            }
+            txLine.take(static_cast<size_t>(n));
+            txBytes.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+            sentOfFront += static_cast<size_t>(n);
+            if (sentOfFront == f.size()) {
+                pending.pop_front();
+                sentOfFront = 0;
+            }
+        }
+
+        // Sleep until input arrives, the line has room or an echo is due
+        now = monotonicNs();
+        uint64_t waitNs = static_cast<uint64_t>(kMaxPollMs) * 1000000;
+        struct pollfd pfd = {masterFd, 0, 0};
+        if (rxLine.waitNs() == 0)
+            pfd.events |= POLLIN;
+        else
+            waitNs = std::min(waitNs, rxLine.waitNs());
+        if (!pending.empty()) {
+            const uint64_t due = pending.front().dueNs;
+            if (due > now)
+                waitNs = std::min(waitNs, due - now);
+            else if (blocked)
+                pfd.events |= POLLOUT;
+            else
+                waitNs = std::min(waitNs, txLine.waitNs());
+        }
+#ifdef __linux__
+        const struct timespec timeout = {static_cast<time_t>(waitNs / 1000000000),
+                                         static_cast<long>(waitNs % 1000000000)};
+        ppoll(&pfd, 1, &timeout, nullptr);
+#else
+        poll(&pfd, 1, static_cast<int>((waitNs + 999999) / 1000000));
+#endif
+    }
+}
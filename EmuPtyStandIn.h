@@ -0,0 +1,80 @@
+#ifndef EMUPTYSTANDIN_H
+#define EMUPTYSTANDIN_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "EmuFirmwareModel.h"
+
+// Software stand-in for the emulator board on a Linux / POSIX
+// pseudo-terminal, for development and CI without hardware.
+//
+// start() creates a pty and runs EmuFirmwareModel on its own thread behind
+// the master side; the slave side (slavePath(), optionally reachable through
+// a symlink such as /tmp/ttyEMU0) is opened by SerialWorker like any COM
+// port. A pty has no line rate of its own, so the stand-in paces both
+// directions at a virtual baud rate: input is only read and output only
+// written at baudRate / bitsPerChar bytes per second, which makes the PC side
+// see the same back-pressure and throughput limit as a real UART. Echoes can
+// additionally be held back by a fixed firmware response delay.
+class EmuPtyStandIn
+{
+public:
+    static constexpr const char *kLinkPrefix = "/tmp/ttyEMU";   // PortScanner lists these
+
+    struct Config
+    {
+        uint32_t baudRate = 0;          // virtual line rate, 0 = unlimited
+        int bitsPerChar = 10;           // 8N1
+        uint32_t responseDelayUs = 0;   // frame received -> echo written
+        std::string linkPath;           // symlink to the slave, empty for none
+    };
+
+    struct Stats
+    {
+        uint64_t rxBytes = 0;           // PC -> stand-in
+        uint64_t txBytes = 0;           // stand-in -> PC
+        uint64_t frames = 0;
+        uint64_t dpecErrors = 0;
+        uint64_t droppedBytes = 0;
+    };
+
+    EmuPtyStandIn() = default;
+    ~EmuPtyStandIn();
+
+    EmuPtyStandIn(const EmuPtyStandIn &) = delete;
+    EmuPtyStandIn &operator=(const EmuPtyStandIn &) = delete;
+
+    bool start(const Config &config, std::string *error = nullptr);
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+    const std::string &slavePath() const { return slave; }
+    const std::string &linkPath() const { return cfg.linkPath; }
+
+    // Any thread
+    Stats stats() const;
+
+    // First free kLinkPrefix<N> path
+    static std::string nextFreeLinkPath();
+
+private:
+    void run();
+
+    Config cfg;
+    int masterFd = -1;
+    int slaveFd = -1;       // kept open so the master never reads EIO between clients
+    std::string slave;
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+    std::atomic<uint64_t> rxBytes{0};
+    std::atomic<uint64_t> txBytes{0};
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> dpecErrors{0};
+    std::atomic<uint64_t> droppedBytes{0};
+};
+
+#endif // EMUPTYSTANDIN_H
@@ -0,0 +1,187 @@
+#include "EmuRegisterDecoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "LibPecBatchCalc.h"
+
+namespace {
+
+constexpr size_t kRecordLen = EmuFrame::kBurstRecordLen;
+constexpr int kAuxGroupBase = 6;    // index of RDAUXA in EmuFrame::kRegGroups
+constexpr int kCfgGroupBase = 11;   // index of RDCFGA
+
+} // namespace
+
+EmuRegisterDecoder::EmuRegisterDecoder()
+{
+    grow(1);
+}
+
+void EmuRegisterDecoder::reset()
+{
+    count = 0;
+    capacity = 0;
+    cells.clear();
+    aux.clear();
+    cfg.clear();
+    counters.clear();
+    grow(1);
+    st = Stats();
+    staged.clear();
+    records.clear();
+    burstRemaining = 0;
+}
+
+void EmuRegisterDecoder::grow(int afes)
+{
+    if (static_cast<size_t>(afes) <= capacity)
+        return;
+
+    // 以 2 倍成長，長鏈讀回時不必每顆 AFE 重排一次
+    const size_t next = std::min<size_t>(kMaxAfes, std::max<size_t>(static_cast<size_t>(afes), capacity * 2));
+    auto reshape = [this, next](std::vector<double> &v, int channels) {
+        std::vector<double> out(static_cast<size_t>(channels) * next, std::nan(""));
+        for (int ch = 0; ch < channels && capacity > 0; ++ch)
+            std::copy_n(&v[static_cast<size_t>(ch) * capacity], capacity, &out[static_cast<size_t>(ch) * next]);
+        v.swap(out);
+    };
+    reshape(cells, kCellChannels);
+    reshape(aux, kAuxChannels);
+    cfg.resize(next * kCfgGroups * EmuFrame::kRegDataLen, 0);
+    counters.resize(next * EmuFrame::kRegGroupCount);
+    capacity = next;
+}
+
+void EmuRegisterDecoder::addFrame(const uint8_t *frame, int size, uint64_t timestampNs)
+{
+    // A new frame ends any burst still waiting for payload
+    burstRemaining = 0;
+    staged.resize(records.size() * kRecordLen);
+
+    if (size < APP_EMU_UART_PACKET_LEN || frame[APP_EMU_A_HEAD1] != APP_EMU_UART_HAED1 ||
+        frame[APP_EMU_A_HEAD2] != APP_EMU_UART_HAED2 || EmuFrame::checksum(frame) != frame[APP_EMU_A_CHECKSUM]) {
+        ++st.ignored;
+        return;
+    }
+    const uint16_t cmd = static_cast<uint16_t>((frame[APP_EMU_A_CMD3] << 8) | frame[APP_EMU_A_CMD4]);
+    const uint16_t afe = static_cast<uint16_t>(frame[APP_EMU_A_AFEINDEX] | (frame[APP_EMU_A_AFEINDEX_HI] << 8));
+
+    if (EmuFrame::isBurst(frame)) {
+        const int len = EmuFrame::burstPayloadLen(frame);
+        if (!EmuFrame::burstHeaderOk(frame)) {
+            ++st.ignored;
+            return;
+        }
+        burstRemaining = len;
+        burstTimestampNs = timestampNs;
+        burstAfe = afe;
+        burstFirstGroup = frame[APP_EMU_A_DATA];
+        burstGroups = frame[APP_EMU_A_DATA + 1];
+        burstRecord = 0;
+        if (size > APP_EMU_UART_PACKET_LEN)
+            addBurstData(frame + APP_EMU_UART_PACKET_LEN, std::min(size - APP_EMU_UART_PACKET_LEN, len));
+        return;
+    }
+
+    const int group = EmuFrame::regGroupIndex(cmd);
+    if (group < 0)
+        return;     // control frame echo
+    if (afe >= kMaxAfes) {
+        ++st.ignored;
+        return;
+    }
+    staged.insert(staged.end(), frame + APP_EMU_A_DATA, frame + APP_EMU_A_DATA + kRecordLen);
+    records.push_back({timestampNs, afe, static_cast<uint8_t>(group)});
+}
+
+void EmuRegisterDecoder::addBurstData(const uint8_t *data, int size)
+{
+    size = std::min(size, burstRemaining);
+    if (size <= 0)
+        return;
+    burstRemaining -= size;
+    staged.insert(staged.end(), data, data + size);
+
+    // Records completed by these bytes
+    while (staged.size() >= (records.size() + 1) * kRecordLen) {
+        const int afe = burstAfe + burstRecord / burstGroups;
+        const int group = burstFirstGroup + burstRecord % burstGroups;
+        ++burstRecord;
+        if (afe >= kMaxAfes) {
+            staged.erase(staged.begin() + static_cast<std::ptrdiff_t>(records.size() * kRecordLen),
+                         staged.begin() + static_cast<std::ptrdiff_t>((records.size() + 1) * kRecordLen));
+            ++st.ignored;
+            continue;
+        }
+        records.push_back({burstTimestampNs, static_cast<uint16_t>(afe), static_cast<uint8_t>(group)});
+    }
+}
+
+void EmuRegisterDecoder::codesToVolts(const uint16_t *codes, double *volts, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        volts[i] = static_cast<double>(codes[i]) * 150e-6 + 1.5;
+}
+
+size_t EmuRegisterDecoder::flush()
+{
+    const size_t n = records.size();
+    if (n == 0)
+        return 0;
+
+    // 1. DPEC, DPEC1 follows the data of each record as the batch CRC expects
+    dpec.resize(n);
+    pec10_calc_batch(true, EmuFrame::kRegDataLen, staged.data(), kRecordLen, n, dpec.data());
+
+    // 2. Every code of the batch (config bytes too, unused) -> V
+    codes.resize(n * 3);
+    volts.resize(n * 3);
+    const uint8_t *p = staged.data();
+    for (size_t r = 0; r < n; ++r)
+        for (size_t i = 0; i < 3; ++i)
+            codes[r * 3 + i] = static_cast<uint16_t>(p[r * kRecordLen + 2 * i] | (p[r * kRecordLen + 2 * i + 1] << 8));
+    codesToVolts(codes.data(), volts.data(), n * 3);
+
+    // 3. Scatter
+    size_t stored = 0;
+    for (size_t r = 0; r < n; ++r) {
+        const uint8_t *rec = p + r * kRecordLen;
+        const int afe = records[r].afe;
+        const int g = records[r].group;
+        if (afe >= count) {
+            grow(afe + 1);
+            count = afe + 1;
+        }
+        GroupCounters &c = counters[static_cast<size_t>(afe) * EmuFrame::kRegGroupCount + static_cast<size_t>(g)];
+
+        const uint16_t rx = static_cast<uint16_t>(((rec[EmuFrame::kRegDataLen] & 0x03) << 8) | rec[EmuFrame::kRegDataLen + 1]);
+        if (dpec[r] != rx) {
+            ++c.dpecErrors;
+            ++st.dpecErrors;
+            continue;
+        }
+
+        if (g >= kCfgGroupBase) {
+            std::memcpy(&cfg[(static_cast<size_t>(afe) * kCfgGroups + static_cast<size_t>(g - kCfgGroupBase)) * EmuFrame::kRegDataLen],
+                        rec, EmuFrame::kRegDataLen);
+        } else {
+            // cells: channel 3g..; aux: channel 3(g-6)..
+            double *base = (g < kAuxGroupBase) ? &cells[static_cast<size_t>(g) * 3 * capacity]
+                                               : &aux[static_cast<size_t>(g - kAuxGroupBase) * 3 * capacity];
+            for (size_t i = 0; i < 3; ++i)
+                base[i * capacity + static_cast<size_t>(afe)] = volts[r * 3 + i];
+            if (history && g < kAuxGroupBase)
+                history->append(afe, g, &codes[r * 3], records[r].timestampNs);
+        }
+        ++c.updates;
+        ++stored;
+    }
+    st.records += stored;
+
+    // Keep the bytes of a burst record not complete yet
+    staged.erase(staged.begin(), staged.begin() + static_cast<std::ptrdiff_t>(n * kRecordLen));
+    records.clear();
+    return stored;
+}
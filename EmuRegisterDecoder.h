@@ -0,0 +1,111 @@
+#ifndef EMUREGISTERDECODER_H
+#define EMUREGISTERDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EmuCellHistory.h"
+#include "EmuChainModel.h"
+#include "EmuFrame.h"
+
+// Typed register values of one emulator board, decoded from its RX frames.
+//
+// Register group frames and 0x8030 bursts are only staged by addFrame() /
+// addBurstData(), as 8-byte records in the burst layout (6 data bytes +
+// DPEC1/DPEC2). flush() then decodes the whole batch at once:
+//   1. DPEC of every record in one pec10_calc_batch call (same result as
+//      pec10_calc per frame)
+//   2. code -> voltage (code x 150uV + 1.5V, the inverse of
+//      EmuProtocol_VoltageToBytes) for all codes in one vectorizable loop
+//   3. scatter into per-channel arrays indexed by AFE, the EmuChainModel
+//      layout, and raw copies of the RDCFGA/B bytes
+// A record with a bad DPEC is counted and keeps the previous value.
+// Channels never received read as NaN. With setHistory() every stored cell
+// group is also appended, with its RX timestamp, to an EmuCellHistory.
+class EmuRegisterDecoder
+{
+public:
+    static constexpr int kMaxAfes = APP_AFECASE_NUM_MAX;
+    static constexpr int kCellChannels = EmuChainModel::kCellChannels;
+    static constexpr int kAuxChannels = EmuChainModel::kAuxChannels;
+    static constexpr int kCfgGroups = EmuChainModel::kCfgGroups;
+
+    struct Stats
+    {
+        uint64_t records = 0;       // stored
+        uint64_t dpecErrors = 0;    // dropped
+        uint64_t ignored = 0;       // bad frames, AFE index out of range
+    };
+
+    EmuRegisterDecoder();
+
+    // A 16 bytes frame (control frames and burst acks are skipped) or a
+    // whole burst; a burst header alone is followed by addBurstData()
+    void addFrame(const uint8_t *frame, int size, uint64_t timestampNs = 0);
+    // Next payload bytes of the burst whose header was added last
+    void addBurstData(const uint8_t *data, int size);
+    // Decodes everything staged; returns the records stored
+    size_t flush();
+
+    void reset();
+
+    void setHistory(EmuCellHistory *h) { history = h; }    // nullptr: none
+
+    int afeCount() const { return count; }     // highest AFE index seen + 1
+    const double *cellVolts(int channel) const { return &cells[static_cast<size_t>(channel) * capacity]; }
+    const double *auxVolts(int channel) const { return &aux[static_cast<size_t>(channel) * capacity]; }
+    const uint8_t *config(int afe, int group) const { return &cfg[(static_cast<size_t>(afe) * kCfgGroups + static_cast<size_t>(group)) * EmuFrame::kRegDataLen]; }
+
+    // Per AFE and EmuFrame::kRegGroups index
+    uint32_t updates(int afe, int group) const { return counters[static_cast<size_t>(afe) * EmuFrame::kRegGroupCount + static_cast<size_t>(group)].updates; }
+    uint32_t dpecErrors(int afe, int group) const { return counters[static_cast<size_t>(afe) * EmuFrame::kRegGroupCount + static_cast<size_t>(group)].dpecErrors; }
+
+    const Stats &stats() const { return st; }
+
+    // Bulk code x 150uV + 1.5V, in V
+    static void codesToVolts(const uint16_t *codes, double *volts, size_t n);
+
+private:
+    struct Record
+    {
+        uint64_t timestampNs;
+        uint16_t afe;
+        uint8_t group;
+    };
+
+    struct GroupCounters
+    {
+        uint32_t updates = 0;
+        uint32_t dpecErrors = 0;
+    };
+
+    void stage(const uint8_t *data, int size);
+    void grow(int afes);
+
+    int count = 0;
+    size_t capacity = 0;
+    std::vector<double> cells;              // [channel][capacity]
+    std::vector<double> aux;                // [channel][capacity]
+    std::vector<uint8_t> cfg;               // [afe][group][6]
+    std::vector<GroupCounters> counters;    // [afe][group]
+    Stats st;
+    EmuCellHistory *history = nullptr;
+
+    // Staged batch
+    std::vector<uint8_t> staged;            // [record][8], may end with a partial burst record
+    std::vector<Record> records;
+    int burstRemaining = 0;                 // payload bytes still expected
+    uint64_t burstTimestampNs = 0;
+    uint16_t burstAfe = 0;
+    uint8_t burstFirstGroup = 0;
+    uint8_t burstGroups = 1;
+    int burstRecord = 0;
+
+    // flush() scratch
+    std::vector<uint16_t> dpec;
+    std::vector<uint16_t> codes;
+    std::vector<double> volts;
+};
+
+#endif // EMUREGISTERDECODER_H
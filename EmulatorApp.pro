@@ -3,19 +3,49 @@ QT       += serialport
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
-CONFIG += c++11
+CONFIG += c++17
 
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+include(emucore.pri)
+
 SOURCES += \
-    LibCrc15Crc10TableCalc.c \
+    CaptureReplayer.cpp \
+    EmuCaptureReader.cpp \
+    EmuLog.cpp \
+    FrameLogModel.cpp \
+    HeadlessRunner.cpp \
+    PlotPanel.cpp \
+    PlotViews.cpp \
+    PortManager.cpp \
+    PortScanner.cpp \
+    ReadbackModel.cpp \
+    ReadbackPanel.cpp \
+    RxStreamDiff.cpp \
+    SerialWorker.cpp \
+    StimulusEngine.cpp \
+    StimulusPanel.cpp \
     main.cpp \
     mainwindow.cpp
 
 HEADERS += \
-    LibCrc15Crc10TableCalc.h \
+    CaptureReplayer.h \
+    EmuCaptureReader.h \
+    EmuLog.h \
+    FrameLogModel.h \
+    HeadlessRunner.h \
+    PlotPanel.h \
+    PlotViews.h \
+    PortManager.h \
+    PortScanner.h \
+    ReadbackModel.h \
+    ReadbackPanel.h \
+    RxStreamDiff.h \
+    SerialWorker.h \
+    StimulusEngine.h \
+    StimulusPanel.h \
     mainwindow.h
 
 FORMS += \
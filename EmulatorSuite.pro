@@ -0,0 +1,18 @@
+# Builds the GUI and the headless tools together:
+#   qmake EmulatorSuite.pro && make
+# EmulatorApp.pro can still be opened on its own.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    app \
+    bench
+
+app.file = EmulatorApp.pro
+bench.subdir = bench
+
+# Firmware stand-in on a pseudo-terminal, for testing without the board
+unix {
+    SUBDIRS += standin
+    standin.subdir = standin
+}
@@ -0,0 +1,127 @@
+#include "FrameLogModel.h"
+
+#include <QBrush>
+#include <QColor>
+
+#include <algorithm>
+#include <cstring>
+
+#include "HexFormat.h"
+
+#define APP_LOG_REFRESH_INTERVAL        (33)    //ms, ~30Hz
+
+FrameLogModel::FrameLogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent)
+    , ring(static_cast<size_t>(std::max(capacity, 1)))
+    , queued(ring.size())
+    , refreshTimer(new QTimer(this))
+{
+    refreshTimer->setSingleShot(true);
+    refreshTimer->setInterval(APP_LOG_REFRESH_INTERVAL);
+    connect(refreshTimer, &QTimer::timeout, this, &FrameLogModel::publish);
+}
+
+void FrameLogModel::append(Kind kind, const uint8_t *data, int size, uint8_t port)
+{
+    // 超過容量時只保留最新的資料: 覆蓋最舊的一筆
+    Entry *e;
+    if (queuedCount == queued.size()) {
+        e = &queued[queuedFirst];
+        queuedFirst = (queuedFirst + 1) % queued.size();
+    } else {
+        e = &queued[(queuedFirst + queuedCount) % queued.size()];
+        ++queuedCount;
+    }
+    e->kind = kind;
+    e->port = port;
+    e->size = static_cast<uint8_t>(std::min(size, APP_EMU_UART_PACKET_LEN));
+    std::memcpy(e->data, data, e->size);
+
+    if (!refreshTimer->isActive())
+        refreshTimer->start();
+}
+
+void FrameLogModel::clear()
+{
+    beginResetModel();
+    first = 0;
+    count = 0;
+    queuedFirst = 0;
+    queuedCount = 0;
+    endResetModel();
+}
+
+void FrameLogModel::publish()
+{
+    if (queuedCount == 0)
+        return;
+
+    const int capacity = static_cast<int>(ring.size());
+    const int n = static_cast<int>(queuedCount);
+
+    // Drop the oldest rows to make room
+    const int overflow = count + n - capacity;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        first = (first + static_cast<size_t>(overflow)) % ring.size();
+        count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), count, count + n - 1);
+    for (int i = 0; i < n; ++i)
+        ring[(first + static_cast<size_t>(count + i)) % ring.size()] =
+            queued[(queuedFirst + static_cast<size_t>(i)) % queued.size()];
+    count += n;
+    endInsertRows();
+
+    queuedFirst = 0;
+    queuedCount = 0;
+    emit rowsPublished();
+}
+
+int FrameLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : count;
+}
+
+QVariant FrameLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= count)
+        return QVariant();
+
+    const Entry &e = at(index.row());
+
+    if (role == Qt::DisplayRole) {
+        const char *prefix = "";
+        switch (e.kind) {
+        case Tx:          prefix = "TX: "; break;
+        case Rx:          prefix = "RX: "; break;
+        case RxDpecError: prefix = "RX (DPEC ERR): "; break;
+        case RxDrop:      prefix = "RX (Drop): "; break;
+        case RxRemain:    prefix = "RX (Rem): "; break;
+        case RxBurst:     prefix = "RX (Burst): "; break;
+        }
+
+        // 一次寫入固定大小的 buffer，只產生最後的 QString
+        char line[32 + HexFormat::bufferSize(APP_EMU_UART_PACKET_LEN)];
+        size_t len = 0;
+        if (e.port != 0) {
+            line[len++] = 'P';
+            line[len++] = static_cast<char>('0' + e.port % 10);
+            line[len++] = ' ';
+        }
+        const size_t prefixLen = std::strlen(prefix);
+        std::memcpy(line + len, prefix, prefixLen);
+        len += prefixLen;
+        const size_t hexLen = HexFormat::format(e.data, e.size, line + len);
+        return QString::fromLatin1(line, static_cast<int>(len + hexLen));
+    }
+
+    if (role == Qt::ForegroundRole) {
+        if (e.kind == RxDpecError || e.kind == RxDrop)
+            return QBrush(QColor(Qt::darkRed));
+    }
+
+    return QVariant();
+}
@@ -0,0 +1,69 @@
+#ifndef FRAMELOGMODEL_H
+#define FRAMELOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QTimer>
+
+#include <cstdint>
+#include <vector>
+
+#include "EmuProtocol.h"
+
+// Fixed-capacity TX/RX traffic log.
+//
+// Frames are stored raw in a ring; the hex text of a row is only built when a
+// view asks for it, so a QListView (uniformItemSizes) renders just the
+// visible rows. append() is cheap and only queues the frame: rows are
+// published to views at most every APP_LOG_REFRESH_INTERVAL ms, and the
+// oldest rows are dropped once the capacity is reached.
+class FrameLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Kind : uint8_t
+    {
+        Tx,
+        Rx,
+        RxDpecError,    // valid frame, bad DPEC
+        RxDrop,         // bytes skipped while hunting the header
+        RxRemain,       // partial frame flushed after an RX line gap
+        RxBurst         // payload bytes of the 0x8030 burst above
+    };
+
+    explicit FrameLogModel(int capacity, QObject *parent = nullptr);
+
+    // port: emulator board (PortManager id), shown as "P<n> " when not 0
+    void append(Kind kind, const uint8_t *data, int size, uint8_t port = 0);
+    void clear();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+signals:
+    void rowsPublished();   // emitted after each coalesced refresh
+
+private slots:
+    void publish();
+
+private:
+    struct Entry
+    {
+        uint8_t kind;
+        uint8_t port;
+        uint8_t size;
+        uint8_t data[APP_EMU_UART_PACKET_LEN];
+    };
+
+    const Entry &at(int row) const { return ring[(first + static_cast<size_t>(row)) % ring.size()]; }
+
+    std::vector<Entry> ring;
+    size_t first = 0;           // ring index of row 0
+    int count = 0;              // published rows
+    std::vector<Entry> queued;  // appended but not yet published, same capacity ring
+    size_t queuedFirst = 0;     // oldest queued entry
+    size_t queuedCount = 0;
+    QTimer *refreshTimer;
+};
+
+#endif // FRAMELOGMODEL_H
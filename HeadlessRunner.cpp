@@ -0,0 +1,736 @@
+#include "HeadlessRunner.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QMetaObject>
+#include <QRegularExpression>
+#include <QSerialPort>
+
+#include <algorithm>
+#include <cstring>
+
+#include "EmuFrame.h"
+#include "EmuLog.h"
+#include "EmuProtocol.h"
+#include "HexFormat.h"
+
+#define HEADLESS_RX_POLL_INTERVAL       (10)    //ms
+#define HEADLESS_REPLAY_SETTLE_TIME     (2 * APP_EMU_REMAIN_DATA_DELAY)    //ms
+
+namespace {
+
+// 0x8010 Data1 per EmuFrame::kRegGroups entry
+constexpr uint8_t kRangeCmdType[EmuFrame::kRegGroupCount] = {
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x11, 0x12, 0x13, 0x14, 0x15,
+    0x20, 0x21
+};
+
+int findRegGroup(const QString &name)
+{
+    for (int i = 0; i < EmuFrame::kRegGroupCount; ++i)
+        if (name.compare(QLatin1String(EmuFrame::kRegGroups[i].name), Qt::CaseInsensitive) == 0)
+            return i;
+    return -1;
+}
+
+// "0xHHHH" raw code or a voltage in V
+bool parseCode(const QString &text, uint16_t &out)
+{
+    bool ok = false;
+    if (text.startsWith("0x", Qt::CaseInsensitive)) {
+        out = text.toUShort(&ok, 16);
+        return ok;
+    }
+    const double v = text.toDouble(&ok);
+    if (!ok)
+        return false;
+    uint8_t bytes[2];
+    EmuProtocol_VoltageToBytes(v * 1000000.0, bytes);
+    out = static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+    return true;
+}
+
+bool parseUInt(const QString &text, uint32_t max, uint32_t &out)
+{
+    bool ok = false;
+    out = text.toUInt(&ok, 0);
+    return ok && out <= max;
+}
+
+} // namespace
+
+HeadlessRunner::HeadlessRunner(QObject *parent)
+    : QObject(parent)
+    , ports(new PortManager(this))
+    , worker(ports->primary())
+    , stimThread(new QThread(this))
+    , stimEngine(new StimulusEngine(worker))
+    , replayThread(new QThread(this))
+    , replayer(new CaptureReplayer(worker))
+    , rxPollTimer(new QTimer(this))
+    , stepTimer(new QTimer(this))
+    , statsTimer(new QTimer(this))
+{
+    connect(ports, &PortManager::portOpened, this, &HeadlessRunner::onPortOpened);
+    connect(ports, &PortManager::portLost, this, [](int id, const QString &message) {
+        std::fprintf(stderr, "port %d: lost (%s), waiting for the device\n", id, qPrintable(message));
+    });
+    connect(ports, &PortManager::portReopened, this, [](int id, bool ok, const QString &message) {
+        std::fprintf(stderr, "port %d: reopen %s (%s)\n", id, ok ? "OK" : "FAIL", qPrintable(message));
+    });
+    connect(worker, &SerialWorker::probeStep, this, [](qint32 baudRate, bool ok, const QString &detail) {
+        std::fprintf(stderr, "probe: %d baud %s (%s)\n", baudRate, ok ? "OK" : "FAIL", qPrintable(detail));
+    });
+    connect(worker, &SerialWorker::probeFinished, this, &HeadlessRunner::onProbeFinished);
+
+    stimEngine->moveToThread(stimThread);
+    connect(stimThread, &QThread::finished, stimEngine, &QObject::deleteLater);
+    connect(stimEngine, &StimulusEngine::statusUpdated, this, [this](const StimulusEngine::Status &s) {
+        stimStatus = s;
+    });
+    connect(stimEngine, &StimulusEngine::stopped, this, [this]() {
+        stimActive = false;
+        std::fprintf(stderr, "stim: updates %llu, frames %llu, skipped %llu, demand %.0f B/s, link %.0f B/s\n",
+                     static_cast<unsigned long long>(stimStatus.updates),
+                     static_cast<unsigned long long>(stimStatus.frames),
+                     static_cast<unsigned long long>(stimStatus.skipped),
+                     stimStatus.demandBytesPerSec, stimStatus.linkBytesPerSec);
+        runNext();
+    });
+    stimThread->start();
+
+    replayer->moveToThread(replayThread);
+    connect(replayThread, &QThread::finished, replayer, &QObject::deleteLater);
+    connect(replayer, &CaptureReplayer::finished, this, [this](bool ok, const QString &message) {
+        if (finished)
+            return;
+        std::fprintf(stderr, "replay: %s\n", qPrintable(message));
+        if (!ok) {
+            rxDiff.close();
+            fail(ExitPort, message);
+            return;
+        }
+        // 等最後的回應收完再結算
+        QTimer::singleShot(HEADLESS_REPLAY_SETTLE_TIME, this, [this]() {
+            onRxPoll();
+            rxDiff.finish();
+            for (const QString &diff : rxDiff.differences())
+                std::fprintf(stderr, "  %s\n", qPrintable(diff));
+            std::fprintf(stderr, "%s\n", qPrintable(rxDiff.summary()));
+            if (!rxDiff.identical())
+                diffFailed = true;
+            rxDiff.close();
+            runNext();
+        });
+    });
+    replayThread->start();
+
+    rxPollTimer->setInterval(HEADLESS_RX_POLL_INTERVAL);
+    connect(rxPollTimer, &QTimer::timeout, this, &HeadlessRunner::onRxPoll);
+
+    connect(statsTimer, &QTimer::timeout, this, &HeadlessRunner::printStats);
+
+    stepTimer->setSingleShot(true);
+    stepTimer->setTimerType(Qt::PreciseTimer);
+    connect(stepTimer, &QTimer::timeout, this, [this]() {
+        // stim 時間到先停止，等 stopped 再繼續下一行
+        if (stimActive) {
+            QMetaObject::invokeMethod(stimEngine, &StimulusEngine::stop, Qt::QueuedConnection);
+            return;
+        }
+        runNext();
+    });
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    replayThread->quit();
+    replayThread->wait();
+    stimThread->quit();
+    stimThread->wait();
+    delete ports;
+    if (ownsRxOut && rxOut)
+        std::fclose(rxOut);
+}
+
+bool HeadlessRunner::init(const QStringList &arguments, int &exitCode)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless emulator control");
+    parser.addHelpOption();
+    parser.addOption({"headless", "Run without GUI."});
+    parser.addOption({{"s", "script"}, "Command script, '-' for stdin (default).", "file", "-"});
+    parser.addOption({{"o", "rx-out"}, "RX frame output, '-' for stdout (default).", "file", "-"});
+    parser.addOption({{"p", "port"}, "Open this serial port before the script.", "name"});
+    parser.addOption({{"b", "baud"}, "Baud rate (default 115200).", "rate"});
+    parser.addOption({"flow", "Flow control: none (default) or rtscts.", "mode"});
+    parser.addOption({{"c", "capture"}, "Record TX/RX frames to an .emucap file.", "file"});
+    parser.addOption({"stats", "Print link counters to stderr every <ms>.", "ms"});
+#ifdef Q_OS_UNIX
+    parser.addOption({"standin", "Serve a firmware stand-in on a pty at <rate> virtual baud "
+                                 "(0 = unlimited) and open it instead of --port.", "rate"});
+#endif
+
+    if (!parser.parse(arguments)) {
+        std::fprintf(stderr, "%s\n", qPrintable(parser.errorText()));
+        exitCode = ExitUsage;
+        return false;
+    }
+    if (parser.isSet("help")) {
+        std::fprintf(stdout, "%s", qPrintable(parser.helpText()));
+        exitCode = ExitOk;
+        return false;
+    }
+
+    if (parser.isSet("baud")) {
+        bool ok = false;
+        serialConfig.baudRate = parser.value("baud").toInt(&ok);
+        if (!ok || serialConfig.baudRate <= 0) {
+            std::fprintf(stderr, "invalid baud rate\n");
+            exitCode = ExitUsage;
+            return false;
+        }
+    }
+    if (parser.isSet("flow")) {
+        const QString flow = parser.value("flow").toLower();
+        if (flow != "none" && flow != "rtscts") {
+            std::fprintf(stderr, "invalid flow control %s\n", qPrintable(flow));
+            exitCode = ExitUsage;
+            return false;
+        }
+        serialConfig.flowControl = (flow == "rtscts") ? QSerialPort::HardwareControl : QSerialPort::NoFlowControl;
+    }
+
+    QFile in;
+    const QString scriptName = parser.value("script");
+    bool opened = false;
+    if (scriptName == "-") {
+        opened = in.open(stdin, QIODevice::ReadOnly | QIODevice::Text);
+    } else {
+        in.setFileName(scriptName);
+        opened = in.open(QIODevice::ReadOnly | QIODevice::Text);
+    }
+    if (!opened) {
+        std::fprintf(stderr, "cannot read script %s\n", qPrintable(scriptName));
+        exitCode = ExitUsage;
+        return false;
+    }
+    script = QString::fromUtf8(in.readAll()).split('\n');
+
+    if (parser.isSet("port"))
+        portName = parser.value("port");
+
+#ifdef Q_OS_UNIX
+    if (parser.isSet("standin")) {
+        bool ok = false;
+        EmuPtyStandIn::Config config;
+        config.baudRate = parser.value("standin").toUInt(&ok);
+        config.bitsPerChar = serialConfig.bitsPerChar();
+        std::string error;
+        if (!ok || !standIn.start(config, &error)) {
+            std::fprintf(stderr, "cannot start stand-in: %s\n", ok ? error.c_str() : "invalid rate");
+            exitCode = ExitUsage;
+            return false;
+        }
+        portName = QString::fromStdString(standIn.slavePath());
+        std::fprintf(stderr, "stand-in: %s\n", standIn.slavePath().c_str());
+    }
+#endif
+
+    const QString outName = parser.value("rx-out");
+    if (outName == "-") {
+        rxOut = stdout;
+    } else {
+        rxOut = std::fopen(QFile::encodeName(outName).constData(), "wb");
+        if (!rxOut) {
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(outName));
+            exitCode = ExitUsage;
+            return false;
+        }
+        ownsRxOut = true;
+    }
+
+    if (parser.isSet("capture")) {
+        if (!capture.start(QFile::encodeName(parser.value("capture")).constData())) {
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(parser.value("capture")));
+            exitCode = ExitUsage;
+            return false;
+        }
+        ports->setCapture(&capture);
+    }
+
+    if (parser.isSet("stats")) {
+        bool ok = false;
+        const int interval = parser.value("stats").toInt(&ok);
+        if (!ok || interval <= 0) {
+            std::fprintf(stderr, "invalid stats interval\n");
+            exitCode = ExitUsage;
+            return false;
+        }
+        statsTimer->start(interval);
+    }
+    lastLinkSample[0] = worker->linkStats().snapshot();
+
+    rxPollTimer->start();
+    return true;
+}
+
+void HeadlessRunner::runNext()
+{
+    static const QRegularExpression kSpaces("\\s+");
+
+    // --port: 先開埠再執行腳本
+    if (line == 0 && !portName.isEmpty() && !worker->isOpen()) {
+        execute({"open", portName});
+        return;
+    }
+
+    while (!finished && line < script.size()) {
+        QString text = script.at(line++);
+        const int comment = text.indexOf('#');
+        if (comment >= 0)
+            text.truncate(comment);
+        const QStringList args = text.split(kSpaces, Qt::SkipEmptyParts);
+        if (args.isEmpty())
+            continue;
+        if (!execute(args))
+            return;     // 等待中或已結束
+    }
+    finish(ExitOk);
+}
+
+bool HeadlessRunner::execute(const QStringList &args)
+{
+    const QString cmd = args.at(0).toLower();
+    const int argc = args.size();
+    uint32_t u = 0;
+
+    if (cmd == "open") {
+        if (argc < 2)
+            return fail(ExitScript, "usage: open <port> [baud] [rtscts]");
+        SerialConfig config;
+        if (!parsePortOptions(args, config))
+            return false;
+        portName = args.at(1);
+        ports->openPort(0, portName, config);
+        return false;   // 由 onPortOpened 繼續
+    }
+
+    if (cmd == "addport") {
+        if (argc < 2)
+            return fail(ExitScript, "usage: addport <port> [baud] [rtscts]");
+        SerialConfig config;
+        if (!parsePortOptions(args, config))
+            return false;
+        const int id = ports->addPort(args.at(1), config);
+        if (id < 0)
+            return fail(ExitScript, QString("at most %1 ports").arg(PortManager::kMaxPorts));
+        std::fprintf(stderr, "port %d: %s\n", id, qPrintable(args.at(1)));
+        if (capture.isRunning())
+            ports->setCapture(&capture);
+        lastLinkSample[id] = ports->worker(id)->linkStats().snapshot();
+        return false;   // 由 onPortOpened 繼續
+    }
+
+    if (cmd == "target") {
+        if (argc >= 2 && args.at(1).compare("all", Qt::CaseInsensitive) == 0) {
+            target = PortManager::kAllPorts;
+            return true;
+        }
+        if (argc < 2 || !parseUInt(args.at(1), PortManager::kMaxPorts - 1, u) || !ports->worker(static_cast<int>(u)))
+            return fail(ExitScript, "usage: target <all|id>");
+        target = static_cast<int>(u);
+        return true;
+    }
+
+    if (cmd == "probe") {
+        if (argc < 2)
+            return fail(ExitScript, "usage: probe <port> [baud...]");
+        QList<qint32> rates;
+        for (int i = 2; i < argc; ++i) {
+            if (!parseUInt(args.at(i), 0x7FFFFFFF, u) || u == 0)
+                return fail(ExitScript, "invalid baud rate " + args.at(i));
+            rates.append(static_cast<qint32>(u));
+        }
+        if (rates.isEmpty())
+            rates = SerialWorker::defaultProbeRates();
+        std::sort(rates.begin(), rates.end());
+
+        SerialWorker *w = worker;
+        const QString name = args.at(1);
+        const SerialConfig config = serialConfig;
+        QMetaObject::invokeMethod(worker, [w, name, config, rates]() {
+            w->probeBaudRates(name, config, rates);
+        }, Qt::QueuedConnection);
+        return false;   // 由 onProbeFinished 繼續
+    }
+
+    if (cmd == "afe") {
+        if (argc < 2 || !parseUInt(args.at(1), APP_AFECASE_NUM_MAX, u) || u == 0)
+            return fail(ExitScript, "usage: afe <total 1~" + QString::number(APP_AFECASE_NUM_MAX) + "> [init]");
+        const bool initDevice = argc > 2 && args.at(2).compare("init", Qt::CaseInsensitive) == 0;
+        return send(EmuFrame::encodeAfeTotal(static_cast<uint16_t>(u), initDevice), "SendTotalAFE:");
+    }
+
+    if (cmd == "cells") {
+        uint16_t c[3];
+        uint32_t first = 0, last = 0;
+        const int group = (argc >= 6) ? findRegGroup(args.at(1)) : -1;
+        const QStringList afes = (argc >= 6) ? args.at(2).split('-') : QStringList();
+        if (group < 0 || afes.size() > 2 || !parseUInt(afes.value(0), APP_AFECASE_NUM_MAX - 1, first) ||
+            !parseUInt(afes.value(afes.size() - 1), APP_AFECASE_NUM_MAX - 1, last) || last < first ||
+            !parseCode(args.at(3), c[0]) || !parseCode(args.at(4), c[1]) || !parseCode(args.at(5), c[2]))
+            return fail(ExitScript, "usage: cells <group> <afe|first-last> <v1> <v2> <v3> [badpec]");
+        const bool correctPec = !(argc > 6 && args.at(6).compare("badpec", Qt::CaseInsensitive) == 0);
+        uint8_t data[EmuFrame::kRegDataLen];
+        for (int i = 0; i < 3; ++i) {
+            data[2 * i] = static_cast<uint8_t>(c[i] & 0xFF);
+            data[2 * i + 1] = static_cast<uint8_t>(c[i] >> 8);
+        }
+        for (uint32_t afe = first; afe <= last; ++afe)
+            if (!send(EmuFrame::kRegGroups[group].encode(static_cast<uint16_t>(afe), data, correctPec), "SendPacket:"))
+                return false;
+        return true;
+    }
+
+    if (cmd == "burst") {
+        uint16_t c[3];
+        uint32_t first = 0, last = 0;
+        const bool all = argc >= 6 && args.at(1).compare("all", Qt::CaseInsensitive) == 0;
+        const int group = all ? 0 : (argc >= 6) ? findRegGroup(args.at(1)) : -1;
+        const QStringList afes = (argc >= 6) ? args.at(2).split('-') : QStringList();
+        if (group < 0 || afes.size() > 2 || !parseUInt(afes.value(0), APP_AFECASE_NUM_MAX - 1, first) ||
+            !parseUInt(afes.value(afes.size() - 1), APP_AFECASE_NUM_MAX - 1, last) || last < first ||
+            !parseCode(args.at(3), c[0]) || !parseCode(args.at(4), c[1]) || !parseCode(args.at(5), c[2]))
+            return fail(ExitScript, "usage: burst <group|all> <afe|first-last> <v1> <v2> <v3> [badpec]");
+        const bool correctPec = !(argc > 6 && args.at(6).compare("badpec", Qt::CaseInsensitive) == 0);
+        const int groups = all ? EmuFrame::kRegGroupCount : 1;
+        const uint32_t afesPerBurst = static_cast<uint32_t>(EmuFrame::kBurstMaxRecords / groups);
+
+        uint8_t data[EmuFrame::kBurstMaxRecords * EmuFrame::kRegDataLen];
+        for (int r = 0; r < EmuFrame::kBurstMaxRecords; ++r) {
+            for (int i = 0; i < 3; ++i) {
+                data[r * EmuFrame::kRegDataLen + 2 * i] = static_cast<uint8_t>(c[i] & 0xFF);
+                data[r * EmuFrame::kRegDataLen + 2 * i + 1] = static_cast<uint8_t>(c[i] >> 8);
+            }
+        }
+        uint8_t frame[APP_EMU_BURST_FRAME_MAX];
+        for (uint32_t afe = first; afe <= last; afe += afesPerBurst) {
+            const uint32_t n = std::min(afesPerBurst, last - afe + 1);
+            const size_t size = EmuFrame::encodeBurst(static_cast<uint16_t>(afe), static_cast<uint16_t>(n), group,
+                                                      groups, data, frame, correctPec);
+            if (!send(frame, static_cast<int>(size), "SendBurst:"))
+                return false;
+        }
+        return true;
+    }
+
+    if (cmd == "range") {
+        uint32_t start = 0, end = 0, step = 0;
+        uint16_t startCode = 0;
+        const int group = (argc >= 6) ? findRegGroup(args.at(1)) : -1;
+        if (group < 0 || !parseUInt(args.at(2), APP_AFECASE_NUM_MAX - 1, start) ||
+            !parseUInt(args.at(3), APP_AFECASE_NUM_MAX - 1, end) ||
+            !parseCode(args.at(4), startCode) || !parseUInt(args.at(5), 0xFFFF, step))
+            return fail(ExitScript, "usage: range <group> <start> <end> <startV> <step>");
+        return send(EmuFrame::encodeRangeVoltage(kRangeCmdType[group], static_cast<uint16_t>(start),
+                                                 static_cast<uint16_t>(end), startCode,
+                                                 static_cast<uint16_t>(step)), "SendRangeVoltage:");
+    }
+
+    if (cmd == "spi") {
+        if (argc < 2 || !parseUInt(args.at(1), 3, u))
+            return fail(ExitScript, "usage: spi <mode 0~3>");
+        return send(EmuFrame::encodeSpiMode(static_cast<uint8_t>(u)), "SendSpiMode:");
+    }
+
+    if (cmd == "stim") {
+        static const char *const kProfiles[] = {"ramp", "sine", "step", "noise"};
+        StimulusConfig config;
+        int profile = -1;
+        for (int i = 0; argc > 1 && i < 4; ++i)
+            if (args.at(1).compare(QLatin1String(kProfiles[i]), Qt::CaseInsensitive) == 0)
+                profile = i;
+        bool ok = profile >= 0 && argc > 2;
+        const double seconds = ok ? args.at(2).toDouble(&ok) : 0.0;
+        if (!ok || seconds <= 0.0)
+            return fail(ExitScript, "usage: stim <ramp|sine|step|noise> <seconds> [key=value...]");
+        config.profile = static_cast<StimulusConfig::Profile>(profile);
+
+        for (int i = 3; i < argc; ++i) {
+            const QString key = args.at(i).section('=', 0, 0).toLower();
+            const QString value = args.at(i).section('=', 1);
+            bool vok = true;
+            if (key == "afe")             config.afeCount = value.toInt(&vok);
+            else if (key == "base")       config.baseV = value.toDouble(&vok);
+            else if (key == "amp")        config.amplitudeV = value.toDouble(&vok);
+            else if (key == "period")     config.periodS = value.toDouble(&vok);
+            else if (key == "imbalance")  config.imbalanceV = value.toDouble(&vok);
+            else if (key == "rate")       config.updateHz = value.toDouble(&vok);
+            else if (key == "aux")        config.aux = true;
+            else if (key == "nocells")    config.cells = false;
+            else                          vok = false;
+            if (!vok)
+                return fail(ExitScript, "invalid stim option " + args.at(i));
+        }
+        const QVector<SerialWorker *> targets = ports->openWorkers();
+        if (targets.isEmpty())
+            return fail(ExitPort, "port not open");
+
+        StimulusEngine *engine = stimEngine;
+        QMetaObject::invokeMethod(stimEngine, [engine, targets, config]() {
+            engine->setTargets(targets);
+            engine->start(config);
+        }, Qt::QueuedConnection);
+        stimStatus = StimulusEngine::Status();
+        stimActive = true;
+        stepTimer->start(static_cast<int>(seconds * 1000.0));
+        return false;
+    }
+
+    if (cmd == "replay") {
+        if (argc < 2)
+            return fail(ExitScript, "usage: replay <file.emucap> [original|fast|<speed>]");
+        int mode = CaptureReplayer::OriginalTiming;
+        double speed = 1.0;
+        if (argc > 2) {
+            const QString m = args.at(2).toLower();
+            bool ok = true;
+            if (m == "fast")
+                mode = CaptureReplayer::AsFastAsPossible;
+            else if (m != "original") {
+                mode = CaptureReplayer::Scaled;
+                speed = m.toDouble(&ok);
+            }
+            if (!ok || speed <= 0.0)
+                return fail(ExitScript, "invalid replay speed " + args.at(2));
+        }
+        if (!worker->isOpen())
+            return fail(ExitPort, "port not open");
+
+        QString error;
+        if (!rxDiff.open(args.at(1), &error))
+            return fail(ExitUsage, "cannot read " + args.at(1) + ": " + error);
+
+        CaptureReplayer *r = replayer;
+        const QString path = args.at(1);
+        QMetaObject::invokeMethod(replayer, [r, path, mode, speed]() {
+            r->start(path, mode, speed);
+        }, Qt::QueuedConnection);
+        return false;   // 由 CaptureReplayer::finished 繼續
+    }
+
+    if (cmd == "stats") {
+        printStats();
+        return true;
+    }
+
+    if (cmd == "latency") {
+        if (argc < 2)
+            return fail(ExitScript, "usage: latency <file.csv|file.json|reset>");
+        if (args.at(1).compare("reset", Qt::CaseInsensitive) == 0) {
+            QMetaObject::invokeMethod(worker, &SerialWorker::resetLatency, Qt::BlockingQueuedConnection);
+            return true;
+        }
+
+        std::vector<LatencyTracker::CommandStats> stats;
+        SerialWorker *w = worker;
+        QMetaObject::invokeMethod(worker, [w, &stats]() {
+            stats = w->latencySnapshot();
+        }, Qt::BlockingQueuedConnection);
+
+        const std::string text = args.at(1).endsWith(".json", Qt::CaseInsensitive) ? LatencyTracker::toJson(stats)
+                                                                                    : LatencyTracker::toCsv(stats);
+        QFile file(args.at(1));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            file.write(text.data(), static_cast<qint64>(text.size())) != static_cast<qint64>(text.size()))
+            return fail(ExitUsage, "cannot write " + args.at(1));
+        return true;
+    }
+
+    if (cmd == "wait") {
+        if (argc < 2 || !parseUInt(args.at(1), 0x7FFFFFFF, u))
+            return fail(ExitScript, "usage: wait <ms>");
+        stepTimer->start(static_cast<int>(u));
+        return false;
+    }
+
+    if (cmd == "close") {
+        for (int id : ports->portIds())
+            ports->closePort(id);
+        return true;
+    }
+
+    if (cmd == "exit") {
+        if (argc > 1 && !parseUInt(args.at(1), 255, u))
+            return fail(ExitScript, "usage: exit [code]");
+        finish(argc > 1 ? static_cast<int>(u) : ExitOk);
+        return false;
+    }
+
+    return fail(ExitScript, "unknown command " + args.at(0));
+}
+
+bool HeadlessRunner::send(const EmuFrame::Frame &frame, const char *tag)
+{
+    return send(frame.data(), static_cast<int>(frame.size()), tag);
+}
+
+bool HeadlessRunner::send(const uint8_t *data, int size, const char *tag)
+{
+    int open = 0;
+    if (target == PortManager::kAllPorts)
+        open = static_cast<int>(ports->openWorkers().size());
+    else if (ports->worker(target) && ports->worker(target)->isOpen())
+        open = 1;
+    if (open == 0)
+        return fail(ExitPort, "port not open");
+    if (ports->post(target, data, size) < open)
+        return fail(ExitTx, "TX queue full");
+    EmuLog_Traffic(tag, data, size);
+    return true;
+}
+
+bool HeadlessRunner::parsePortOptions(const QStringList &args, SerialConfig &config)
+{
+    uint32_t u = 0;
+    config = serialConfig;
+    for (int i = 2; i < args.size(); ++i) {
+        if (args.at(i).compare("rtscts", Qt::CaseInsensitive) == 0)
+            config.flowControl = QSerialPort::HardwareControl;
+        else if (parseUInt(args.at(i), 0x7FFFFFFF, u) && u > 0)
+            config.baudRate = static_cast<qint32>(u);
+        else
+            return fail(ExitScript, "invalid " + args.at(0) + " option " + args.at(i));
+    }
+    return true;
+}
+
+bool HeadlessRunner::fail(int code, const QString &message)
+{
+    std::fprintf(stderr, "line %d: %s\n", line, qPrintable(message));
+    finish(code);
+    return false;
+}
+
+void HeadlessRunner::onPortOpened(int id, bool ok, const QString &message)
+{
+    if (finished)
+        return;
+    if (!ok) {
+        fail(ExitPort, "cannot open " + ports->portName(id) + ": " + message);
+        return;
+    }
+    runNext();
+}
+
+void HeadlessRunner::onProbeFinished(qint32 bestBaudRate)
+{
+    if (bestBaudRate == 0) {
+        fail(ExitPort, "no baud rate passed the loopback test");
+        return;
+    }
+    std::fprintf(stderr, "probe: highest error-free rate %d baud\n", bestBaudRate);
+    serialConfig.baudRate = bestBaudRate;
+    runNext();
+}
+
+void HeadlessRunner::onRxPoll()
+{
+    MergedRxRecord batch[256];
+    size_t n;
+    bool wrote = false;
+
+    while ((n = ports->popRx(batch, 256)) > 0) {
+        for (size_t k = 0; k < n; ++k) {
+            const EmuRxRecord &rec = batch[k].rec;
+            if (rxDiff.isOpen() && batch[k].port == RxStreamDiff::kPort)
+                rxDiff.feed(rec.kind, rec.data, rec.size);
+
+            const char *prefix = "RX ";
+            switch (rec.kind) {
+            case EmuRxRecord::Frame:     prefix = "RX "; break;
+            case EmuRxRecord::DpecError: prefix = "RX_DPEC_ERR "; break;
+            case EmuRxRecord::Garbage:   prefix = "RX_DROP "; break;
+            case EmuRxRecord::Remain:    prefix = "RX_REM "; break;
+            case EmuRxRecord::Burst:     prefix = "RX_BURST "; break;
+            }
+
+            char text[16 + HexFormat::bufferSize(APP_EMU_UART_PACKET_LEN)];
+            size_t len = 0;
+            if (batch[k].port != 0) {
+                text[len++] = 'P';
+                text[len++] = static_cast<char>('0' + batch[k].port % 10);
+                text[len++] = ' ';
+            }
+            const size_t prefixLen = std::strlen(prefix);
+            std::memcpy(text + len, prefix, prefixLen);
+            len += prefixLen;
+            size_t total = len + HexFormat::format(rec.data, rec.size, text + len);
+            text[total++] = '\n';
+            std::fwrite(text, 1, total, rxOut);
+        }
+        wrote = true;
+    }
+    if (wrote)
+        std::fflush(rxOut);
+}
+
+void HeadlessRunner::printStats()
+{
+    const QList<int> ids = ports->portIds();
+    for (int id : ids) {
+        const LinkSnapshot now = ports->worker(id)->linkStats().snapshot();
+        const LinkRates rates = LinkStats::rates(lastLinkSample[id], now);
+        lastLinkSample[id] = now;
+        if (ids.size() > 1)
+            std::fprintf(stderr, "P%d ", id);
+        std::fprintf(stderr, "%s\n", LinkStats::describe(now, rates).c_str());
+    }
+}
+
+void HeadlessRunner::finish(int code)
+{
+    if (finished)
+        return;
+    finished = true;
+    stepTimer->stop();
+    statsTimer->stop();
+
+    QMetaObject::invokeMethod(stimEngine, &StimulusEngine::stop, Qt::BlockingQueuedConnection);
+    QMetaObject::invokeMethod(replayer, &CaptureReplayer::stop, Qt::BlockingQueuedConnection);
+    uint64_t rxOverflows = 0;
+    for (int id : ports->portIds()) {
+        ports->closePort(id);
+        rxOverflows += ports->worker(id)->rxOverflows();
+    }
+    ports->setCapture(nullptr);
+    capture.stop();
+    rxPollTimer->stop();
+    if (rxOut)
+        onRxPoll();
+
+    if (rxOverflows > 0)
+        std::fprintf(stderr, "warning: %llu RX frames dropped\n",
+                     static_cast<unsigned long long>(rxOverflows));
+#ifdef Q_OS_UNIX
+    if (standIn.isRunning()) {
+        standIn.stop();
+        const EmuPtyStandIn::Stats s = standIn.stats();
+        std::fprintf(stderr, "stand-in: rx %llu B, tx %llu B, frames %llu, dpec err %llu\n",
+                     static_cast<unsigned long long>(s.rxBytes), static_cast<unsigned long long>(s.txBytes),
+                     static_cast<unsigned long long>(s.frames), static_cast<unsigned long long>(s.dpecErrors));
+    }
+#endif
+    if (code == ExitOk && diffFailed)
+        code = ExitDiff;
+    if (capture.failed()) {
+        std::fprintf(stderr, "capture file write failed, %llu records kept\n",
+                     static_cast<unsigned long long>(capture.recordsWritten()));
+        if (code == ExitOk)
+            code = ExitCapture;
+    }
+    QCoreApplication::exit(code);
+}
@@ -0,0 +1,122 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+
+#include <cstdio>
+
+#include "CaptureReplayer.h"
+#include "EmuCaptureWriter.h"
+#include "EmuPtyStandIn.h"
+#include "PortManager.h"
+#include "RxStreamDiff.h"
+#include "SerialWorker.h"
+#include "StimulusEngine.h"
+
+// `EmulatorApp --headless`: runs a command script against the emulator
+// board without constructing any widget (QCoreApplication only), streaming
+// RX frames of all ports, merged in time order, as hex lines to stdout or a
+// file (ports other than 0 prefixed "P<id> "). --capture records all TX/RX
+// frames into an EmuCapture file, --stats prints the link counters to
+// stderr periodically, --standin runs against the built-in firmware stand-in
+// (EmuPtyStandIn) instead of a board.
+//
+// Script: one command per line, '#' starts a comment. Voltages are in V or
+// raw 0xHHHH codes, AFE indexes are 0-based.
+//
+//   open  <port> [baud] [rtscts]                port 0 (or --port / --baud / --flow)
+//   addport <port> [baud] [rtscts]              one more board, prints its id
+//   target <all|id>                             where afe/cells/burst/range/spi go
+//                                               (default all open ports)
+//   probe <port> [baud...]                      loopback test, highest
+//                                               passing rate becomes default
+//   afe   <total> [init]                        0x8001
+//   cells <RDCVA..RDCFGB> <afe|first-last> <v1> <v2> <v3> [badpec]
+//   burst <RDCVA..RDCFGB|all> <afe|first-last> <v1> <v2> <v3> [badpec]
+//                                               same as cells in 0x8030 bursts
+//   range <RDCVA..RDCFGB> <start> <end> <startV> <step>   0x8010
+//   spi   <mode>                                0x8020
+//   stim  <ramp|sine|step|noise> <seconds> [afe=N] [base=V] [amp=V]
+//         [period=s] [imbalance=V] [rate=Hz] [aux] [nocells]
+//                                               all open ports, one time base
+//   replay <file.emucap> [original|fast|<speed>]  replay TX on port 0, diff RX
+//   stats                                       print link counters
+//   latency <file.csv|file.json|reset>         TX -> RX latency per command
+//   wait  <ms>                                  keep receiving
+//   close                                       all ports
+//   exit  [code]
+//
+// The script is read completely before it runs, so stdin must be closed
+// (pipe / here-doc).
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ExitCode
+    {
+        ExitOk = 0,
+        ExitUsage = 1,      // bad option, unreadable script or output
+        ExitScript = 2,     // script syntax error
+        ExitPort = 3,       // port open failed / not open
+        ExitTx = 4,         // TX queue full
+        ExitDiff = 5,       // replayed RX differs from the recording
+        ExitCapture = 6     // capture file write failed (disk full, ...)
+    };
+
+    explicit HeadlessRunner(QObject *parent = nullptr);
+    ~HeadlessRunner() override;
+
+    // Parses the command line; false means exit right away with exitCode
+    bool init(const QStringList &arguments, int &exitCode);
+
+public slots:
+    void runNext();
+
+private slots:
+    void onPortOpened(int id, bool ok, const QString &message);
+    void onProbeFinished(qint32 bestBaudRate);
+    void onRxPoll();
+    void printStats();
+
+private:
+    bool execute(const QStringList &args);
+    bool send(const EmuFrame::Frame &frame, const char *tag);
+    bool send(const uint8_t *data, int size, const char *tag);
+    bool fail(int code, const QString &message);
+    bool parsePortOptions(const QStringList &args, SerialConfig &config);
+    void finish(int code);
+
+    PortManager *ports;
+    SerialWorker *worker;       // port 0
+    QThread *stimThread;
+    StimulusEngine *stimEngine;
+    QThread *replayThread;
+    CaptureReplayer *replayer;
+    QTimer *rxPollTimer;
+    QTimer *stepTimer;          // wait / stim duration
+    QTimer *statsTimer;
+    LinkSnapshot lastLinkSample[PortManager::kMaxPorts];
+
+    QStringList script;
+    int line = 0;               // next script line
+    QString portName;
+    int target = PortManager::kAllPorts;
+    SerialConfig serialConfig;
+    FILE *rxOut = nullptr;
+    bool ownsRxOut = false;
+    bool finished = false;
+    bool stimActive = false;
+    StimulusEngine::Status stimStatus;
+    EmuCaptureWriter capture;
+    RxStreamDiff rxDiff;
+    bool diffFailed = false;
+#ifdef Q_OS_UNIX
+    EmuPtyStandIn standIn;
+#endif
+};
+
+#endif // HEADLESSRUNNER_H
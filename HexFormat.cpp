@@ -0,0 +1,41 @@
+#include "HexFormat.h"
+
+namespace {
+
+struct HexTable
+{
+    char digits[256][2];
+};
+
+constexpr HexTable makeHexTable()
+{
+    const char kHex[] = "0123456789ABCDEF";
+    HexTable table{};
+    for (int i = 0; i < 256; ++i) {
+        table.digits[i][0] = kHex[i >> 4];
+        table.digits[i][1] = kHex[i & 0x0F];
+    }
+    return table;
+}
+
+constexpr HexTable kHexTable = makeHexTable();
+
+} // namespace
+
+namespace HexFormat {
+
+size_t format(const uint8_t *data, size_t n, char *out, char sep)
+{
+    char *p = out;
+    for (size_t i = 0; i < n; ++i) {
+        if (i != 0 && sep != '\0')
+            *p++ = sep;
+        const char *d = kHexTable.digits[data[i]];
+        *p++ = d[0];
+        *p++ = d[1];
+    }
+    *p = '\0';
+    return static_cast<size_t>(p - out);
+}
+
+} // namespace HexFormat
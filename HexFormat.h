@@ -0,0 +1,22 @@
+#ifndef HEXFORMAT_H
+#define HEXFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Allocation-free upper case hex dump, e.g. "55 AA 00 04".
+//
+// Uses a 256 entry lookup table and writes into a caller supplied buffer, so
+// formatting a 16 bytes frame is one pass with no temporaries.
+namespace HexFormat {
+
+// Buffer size needed for n bytes with a separator (including the '\0')
+constexpr size_t bufferSize(size_t n) { return n == 0 ? 1 : n * 3; }
+
+// Writes n bytes as "XX XX ..." plus a terminating '\0'; returns the length
+// without the terminator. sep == '\0' packs the digits ("55AA0004").
+size_t format(const uint8_t *data, size_t n, char *out, char sep = ' ');
+
+} // namespace HexFormat
+
+#endif // HEXFORMAT_H
@@ -0,0 +1,72 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Values below 2*kSubBuckets map 1:1; above, the top kSubBits+1 bits are
+// kept, i.e. index = shift * kSubBuckets + (ns >> shift)
+int LatencyHistogram::bucketOf(uint64_t ns)
+{
+    if (ns < 2 * kSubBuckets)
+        return static_cast<int>(ns);
+
+    int msb = 63;
+    while (!(ns >> msb))
+        --msb;
+    const int shift = msb - kSubBits;
+    const int index = shift * static_cast<int>(kSubBuckets) + static_cast<int>(ns >> shift);
+    return std::min(index, kBucketCount - 1);
+}
+
+uint64_t LatencyHistogram::bucketLow(int index)
+{
+    if (index < static_cast<int>(2 * kSubBuckets))
+        return static_cast<uint64_t>(index);
+    const int shift = index / static_cast<int>(kSubBuckets) - 1;
+    const uint64_t mantissa = static_cast<uint64_t>(index % static_cast<int>(kSubBuckets)) + kSubBuckets;
+    return mantissa << shift;
+}
+
+void LatencyHistogram::record(uint64_t ns)
+{
+    ++buckets[static_cast<size_t>(bucketOf(ns))];
+    ++total;
+    minNs = std::min(minNs, ns);
+    maxNs = std::max(maxNs, ns);
+    sumNs += ns;
+}
+
+void LatencyHistogram::reset()
+{
+    *this = LatencyHistogram();
+}
+
+uint64_t LatencyHistogram::quantile(double q) const
+{
+    if (total == 0)
+        return 0;
+    if (q >= 1.0)
+        return maxNs;
+
+    const uint64_t rank = static_cast<uint64_t>(std::ceil(std::max(q, 0.0) * static_cast<double>(total)));
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += buckets[static_cast<size_t>(i)];
+        if (seen >= std::max<uint64_t>(rank, 1)) {
+            const uint64_t low = bucketLow(i);
+            const uint64_t high = (i + 1 < kBucketCount) ? bucketLow(i + 1) : low;
+            return std::min(std::max((low + high) / 2, min()), maxNs);
+        }
+    }
+    return maxNs;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (size_t i = 0; i < buckets.size(); ++i)
+        buckets[i] += other.buckets[i];
+    total += other.total;
+    minNs = std::min(minNs, other.minNs);
+    maxNs = std::max(maxNs, other.maxNs);
+    sumNs += other.sumNs;
+}
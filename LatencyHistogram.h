@@ -0,0 +1,45 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+
+// HDR-style log-linear histogram of nanosecond values.
+//
+// Every power of two is split into kSubBuckets linear buckets, so any
+// recorded value is known to within 1/kSubBuckets (~3%) from 0 up to
+// 2^kMaxBits ns (about 18 minutes) in a fixed ~9 KB array; larger values go
+// to the last bucket. min / max / sum are exact.
+class LatencyHistogram
+{
+public:
+    static constexpr int kSubBits = 5;
+    static constexpr uint64_t kSubBuckets = 1u << kSubBits;     // 32
+    static constexpr int kMaxBits = 40;
+    static constexpr int kBucketCount = (kMaxBits - kSubBits + 1) * static_cast<int>(kSubBuckets) + static_cast<int>(kSubBuckets);
+
+    void record(uint64_t ns);
+    void reset();
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? minNs : 0; }
+    uint64_t max() const { return maxNs; }
+    double mean() const { return total ? static_cast<double>(sumNs) / static_cast<double>(total) : 0.0; }
+
+    // Value at or below which `q` (0~1) of the samples fall, bucket midpoint
+    uint64_t quantile(double q) const;
+
+    void merge(const LatencyHistogram &other);
+
+private:
+    static int bucketOf(uint64_t ns);
+    static uint64_t bucketLow(int index);
+
+    std::array<uint64_t, kBucketCount> buckets{};
+    uint64_t total = 0;
+    uint64_t minNs = UINT64_MAX;
+    uint64_t maxNs = 0;
+    uint64_t sumNs = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
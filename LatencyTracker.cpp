@@ -0,0 +1,162 @@
+#include "LatencyTracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "EmuFrame.h"
+
+uint64_t LatencyTracker::nowNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// CMD1~4 and AFE index
+uint64_t LatencyTracker::keyOf(const uint8_t *frame)
+{
+    uint64_t key = 0;
+    for (int i = APP_EMU_A_CMD1; i <= APP_EMU_A_AFEINDEX; ++i)
+        key = (key << 8) | frame[i];
+    return key;
+}
+
+uint16_t LatencyTracker::commandOf(const uint8_t *frame)
+{
+    return static_cast<uint16_t>((frame[APP_EMU_A_CMD3] << 8) | frame[APP_EMU_A_CMD4]);
+}
+
+LatencyTracker::CommandStats &LatencyTracker::statsOf(uint16_t cmd)
+{
+    CommandStats &s = commands[cmd];
+    s.cmd = cmd;
+    return s;
+}
+
+void LatencyTracker::onTx(const uint8_t *frame, uint64_t ns)
+{
+    Pending &p = pending[keyOf(frame)];
+    if (p.count == kMaxPendingPerKey) {
+        // 最舊的請求沒有回應
+        ++statsOf(commandOf(frame)).unanswered;
+        p.head = static_cast<uint8_t>((p.head + 1) % kMaxPendingPerKey);
+        --p.count;
+    }
+    p.ts[(p.head + p.count) % kMaxPendingPerKey] = ns;
+    ++p.count;
+}
+
+bool LatencyTracker::onRx(const uint8_t *frame, uint64_t ns)
+{
+    auto it = pending.find(keyOf(frame));
+    if (it == pending.end())
+        return false;
+
+    Pending &p = it->second;
+    CommandStats &s = statsOf(commandOf(frame));
+    while (p.count > 0) {
+        const uint64_t sent = p.ts[p.head];
+        p.head = static_cast<uint8_t>((p.head + 1) % kMaxPendingPerKey);
+        --p.count;
+
+        if (ns - std::min(ns, sent) > kTimeoutNs) {
+            ++s.unanswered;
+            continue;
+        }
+        s.histogram.record(ns - std::min(ns, sent));
+        return true;
+    }
+    return false;
+}
+
+void LatencyTracker::reset()
+{
+    pending.clear();
+    commands.clear();
+}
+
+void LatencyTracker::expire(uint64_t ns)
+{
+    for (auto &entry : pending) {
+        Pending &p = entry.second;
+        if (p.count == 0 || ns - std::min(ns, p.ts[p.head]) <= kTimeoutNs)
+            continue;
+        // key 的 CMD3/CMD4 在 AFE index 之前
+        CommandStats &s = statsOf(static_cast<uint16_t>(entry.first >> 8));
+        while (p.count > 0 && ns - std::min(ns, p.ts[p.head]) > kTimeoutNs) {
+            ++s.unanswered;
+            p.head = static_cast<uint8_t>((p.head + 1) % kMaxPendingPerKey);
+            --p.count;
+        }
+    }
+}
+
+std::vector<LatencyTracker::CommandStats> LatencyTracker::snapshot(uint64_t ns)
+{
+    expire(ns);
+
+    std::vector<CommandStats> out;
+    out.reserve(commands.size());
+    for (const auto &entry : commands)
+        out.push_back(entry.second);
+    std::sort(out.begin(), out.end(), [](const CommandStats &a, const CommandStats &b) {
+        return a.cmd < b.cmd;
+    });
+    return out;
+}
+
+namespace {
+
+constexpr double kNsPerUs = 1000.0;
+
+std::string commandLabel(uint16_t cmd)
+{
+    const char *name = EmuFrame::commandName(cmd);
+    if (name)
+        return name;
+    char buf[8];
+    std::snprintf(buf, sizeof(buf), "0x%04X", cmd);
+    return buf;
+}
+
+} // namespace
+
+std::string LatencyTracker::toCsv(const std::vector<CommandStats> &stats)
+{
+    std::string out = "cmd,name,count,unanswered,min_us,mean_us,p50_us,p90_us,p99_us,p999_us,max_us\n";
+    char line[256];
+    for (const CommandStats &s : stats) {
+        const LatencyHistogram &h = s.histogram;
+        std::snprintf(line, sizeof(line), "0x%04X,%s,%llu,%llu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+                      s.cmd, commandLabel(s.cmd).c_str(),
+                      static_cast<unsigned long long>(h.count()), static_cast<unsigned long long>(s.unanswered),
+                      h.min() / kNsPerUs, h.mean() / kNsPerUs,
+                      h.quantile(0.5) / kNsPerUs, h.quantile(0.9) / kNsPerUs, h.quantile(0.99) / kNsPerUs,
+                      h.quantile(0.999) / kNsPerUs, h.max() / kNsPerUs);
+        out += line;
+    }
+    return out;
+}
+
+std::string LatencyTracker::toJson(const std::vector<CommandStats> &stats)
+{
+    std::string out = "[\n";
+    char line[384];
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const CommandStats &s = stats[i];
+        const LatencyHistogram &h = s.histogram;
+        std::snprintf(line, sizeof(line),
+                      "  {\"cmd\": \"0x%04X\", \"name\": \"%s\", \"count\": %llu, \"unanswered\": %llu, "
+                      "\"min_us\": %.1f, \"mean_us\": %.1f, \"p50_us\": %.1f, \"p90_us\": %.1f, "
+                      "\"p99_us\": %.1f, \"p999_us\": %.1f, \"max_us\": %.1f}%s\n",
+                      s.cmd, commandLabel(s.cmd).c_str(),
+                      static_cast<unsigned long long>(h.count()), static_cast<unsigned long long>(s.unanswered),
+                      h.min() / kNsPerUs, h.mean() / kNsPerUs,
+                      h.quantile(0.5) / kNsPerUs, h.quantile(0.9) / kNsPerUs, h.quantile(0.99) / kNsPerUs,
+                      h.quantile(0.999) / kNsPerUs, h.max() / kNsPerUs,
+                      (i + 1 < stats.size()) ? "," : "");
+        out += line;
+    }
+    out += "]\n";
+    return out;
+}
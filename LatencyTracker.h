@@ -0,0 +1,65 @@
+#ifndef LATENCYTRACKER_H
+#define LATENCYTRACKER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "LatencyHistogram.h"
+
+// TX -> RX round-trip latency per command.
+//
+// A TX frame is matched with the next RX frame carrying the same CMD1~4 and
+// AFE index (oldest outstanding first). Both ends are timestamped by the
+// caller with nowNs(), normally on the serial I/O thread right at write /
+// decode. Requests that never get an answer, or wait longer than
+// kTimeoutNs, count as unanswered: when a later answer arrives, or at the
+// latest when a snapshot() taken kTimeoutNs after the TX expires them.
+// Single threaded: take a snapshot() on the owning thread.
+class LatencyTracker
+{
+public:
+    static constexpr int kMaxPendingPerKey = 16;
+    static constexpr uint64_t kTimeoutNs = 5000000000ull;   // 5s
+
+    struct CommandStats
+    {
+        uint16_t cmd = 0;               // CMD3 << 8 | CMD4
+        uint64_t unanswered = 0;
+        LatencyHistogram histogram;
+    };
+
+    void onTx(const uint8_t *frame, uint64_t ns);
+    bool onRx(const uint8_t *frame, uint64_t ns);      // true when matched
+    void reset();
+
+    // Counts requests sent more than kTimeoutNs before ns as unanswered
+    void expire(uint64_t ns);
+
+    // expire(ns), then the stats sorted by command
+    std::vector<CommandStats> snapshot(uint64_t ns);
+
+    static uint64_t nowNs();
+
+    // One row / object per command, latencies in microseconds
+    static std::string toCsv(const std::vector<CommandStats> &stats);
+    static std::string toJson(const std::vector<CommandStats> &stats);
+
+private:
+    struct Pending
+    {
+        uint64_t ts[kMaxPendingPerKey];
+        uint8_t head = 0;
+        uint8_t count = 0;
+    };
+
+    static uint64_t keyOf(const uint8_t *frame);
+    static uint16_t commandOf(const uint8_t *frame);
+    CommandStats &statsOf(uint16_t cmd);
+
+    std::unordered_map<uint64_t, Pending> pending;
+    std::unordered_map<uint16_t, CommandStats> commands;
+};
+
+#endif // LATENCYTRACKER_H
@@ -0,0 +1,122 @@
+/*
+******************************************************************************
+* @file     LibCrc10SliceCalc.cpp
+* @author   Golden Chen
+* @brief    Table-driven and slicing-by-4/8 CRC10(DPEC) engines
+
+******************************************************************************
+* @attention
+*
+* COPYRIGHT(c) 2025 FW Team</center>
+******************************************************************************
+*/
+
+#include "LibCrc15Crc10TableCalc.h"
+
+#include "LibCrcTables.h"
+
+/* Local define -------------------------------------------------------------*/
+namespace {
+
+using LibCrcTables::kCrc10;
+using LibCrcTables::kCrc10Mask;
+using LibCrcTables::kCrc10Seed;
+
+inline uint16_t crc10Byte(uint16_t nRemainder, uint8_t u8Data)
+{
+    return static_cast<uint16_t>(((nRemainder & 0x03u) << 8u)
+                                 ^ kCrc10.Slice[0][((nRemainder >> 2u) ^ u8Data) & 0xFFu]);
+}
+
+/* Fold the optional command counter and run the 6 trailing shifts */
+constexpr uint16_t crc10Finish(uint16_t nRemainder, bool blSrXCmd, uint8_t u8CmdCnt)
+{
+    uint16_t nIndex = static_cast<uint16_t>(nRemainder >> 4u);
+    if (blSrXCmd)
+        nIndex ^= static_cast<uint16_t>(u8CmdCnt >> 2u);
+    return static_cast<uint16_t>((((nRemainder & 0x0Fu) << 6u) ^ kCrc10.Tail[nIndex & 0x3Fu]) & kCrc10Mask);
+}
+
+inline const uint8_t *crc10Slice4(uint16_t &nRemainder, const uint8_t *p, int &nLength)
+{
+    while (nLength >= 4) {
+        nRemainder = kCrc10.Slice[3][((nRemainder >> 2u) ^ p[0]) & 0xFFu]
+                   ^ kCrc10.Slice[2][(((nRemainder & 0x03u) << 6u) ^ p[1]) & 0xFFu]
+                   ^ kCrc10.Slice[1][p[2]]
+                   ^ kCrc10.Slice[0][p[3]];
+        p += 4;
+        nLength -= 4;
+    }
+    return p;
+}
+
+inline const uint8_t *crc10Slice8(uint16_t &nRemainder, const uint8_t *p, int &nLength)
+{
+    while (nLength >= 8) {
+        nRemainder = kCrc10.Slice[7][((nRemainder >> 2u) ^ p[0]) & 0xFFu]
+                   ^ kCrc10.Slice[6][(((nRemainder & 0x03u) << 6u) ^ p[1]) & 0xFFu]
+                   ^ kCrc10.Slice[5][p[2]]
+                   ^ kCrc10.Slice[4][p[3]]
+                   ^ kCrc10.Slice[3][p[4]]
+                   ^ kCrc10.Slice[2][p[5]]
+                   ^ kCrc10.Slice[1][p[6]]
+                   ^ kCrc10.Slice[0][p[7]];
+        p += 8;
+        nLength -= 8;
+    }
+    return p;
+}
+
+/* Pin the documented examples at compile time */
+constexpr uint8_t kExample1[6] = {0x00, 0x80, 0x00, 0x80, 0x00, 0x80};
+constexpr uint8_t kExample2[6] = {0x01, 0x00, 0x00, 0xFF, 0x03, 0x00};
+static_assert(LibCrcTables::pec10Const(kExample1, 6) == 0x02CE, "DPEC Example1 mismatch");
+static_assert(LibCrcTables::pec10Const(kExample2, 6) == 0x005A, "DPEC Example2 mismatch");
+
+} // namespace
+
+/* Global functions ---------------------------------------------------------*/
+
+// Byte-at-a-time crc10Table lookup (1 lookup per byte + 1 for the tail)
+//-----------------------------------------------------------------------------------
+uint16_t pec10_calc_table( bool blSrXCmd, int nLength, uint8_t *pDataBuf)
+{
+    uint16_t nRemainder = kCrc10Seed;
+    for (int i = 0; i < nLength; ++i)
+        nRemainder = crc10Byte(nRemainder, pDataBuf[i]);
+    return crc10Finish(nRemainder, blSrXCmd, blSrXCmd ? pDataBuf[nLength > 0 ? nLength : 0] : 0);
+}
+
+// Slicing-by-4: 4 independent lookups per 4 bytes, remainder bytes by table
+//-----------------------------------------------------------------------------------
+uint16_t pec10_calc_slice4( bool blSrXCmd, int nLength, uint8_t *pDataBuf)
+{
+    uint16_t nRemainder = kCrc10Seed;
+    int nLeft = nLength > 0 ? nLength : 0;
+    const uint8_t *p = crc10Slice4(nRemainder, pDataBuf, nLeft);
+    while (nLeft-- > 0)
+        nRemainder = crc10Byte(nRemainder, *p++);
+    return crc10Finish(nRemainder, blSrXCmd, blSrXCmd ? *p : 0);
+}
+
+// Slicing-by-8: 8 independent lookups per 8 bytes, then by-4, then by table
+//-----------------------------------------------------------------------------------
+uint16_t pec10_calc_slice8( bool blSrXCmd, int nLength, uint8_t *pDataBuf)
+{
+    uint16_t nRemainder = kCrc10Seed;
+    int nLeft = nLength > 0 ? nLength : 0;
+    const uint8_t *p = crc10Slice8(nRemainder, pDataBuf, nLeft);
+    p = crc10Slice4(nRemainder, p, nLeft);
+    while (nLeft-- > 0)
+        nRemainder = crc10Byte(nRemainder, *p++);
+    return crc10Finish(nRemainder, blSrXCmd, blSrXCmd ? *p : 0);
+}
+
+// Default DPEC entry point. Register groups are 6 bytes, which slicing-by-8
+// handles as one by-4 step plus two table steps.
+//-----------------------------------------------------------------------------------
+uint16_t pec10_calc( bool blSrXCmd, int nLength, uint8_t *pDataBuf)
+{
+    return pec10_calc_slice8(blSrXCmd, nLength, pDataBuf);
+}
+//-----------------------------------------------------------------------------------
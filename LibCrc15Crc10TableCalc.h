@@ -28,6 +28,12 @@ extern "C" {
 uint16_t Pec15_Calc(uint8_t len, uint8_t *data);
 uint16_t pec10_calc( bool blSrXCmd, int nLength, uint8_t *pDataBuf);
 
+/* CRC10(DPEC) engines, all bit-exact with pec10_calc_bitwise() */
+uint16_t pec10_calc_bitwise( bool blSrXCmd, int nLength, uint8_t *pDataBuf);
+uint16_t pec10_calc_table( bool blSrXCmd, int nLength, uint8_t *pDataBuf);
+uint16_t pec10_calc_slice4( bool blSrXCmd, int nLength, uint8_t *pDataBuf);
+uint16_t pec10_calc_slice8( bool blSrXCmd, int nLength, uint8_t *pDataBuf);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,118 @@
+/*
+******************************************************************************
+* @file     LibCrcTables.h
+* @author   Golden Chen
+* @brief    Compile-time generated CRC15/CRC10 lookup tables (C++ only)
+
+******************************************************************************
+* @attention
+*
+* COPYRIGHT(c) 2025 FW Team</center>
+******************************************************************************
+*/
+#ifndef __LIB_CRC_TABLES_H__
+#define __LIB_CRC_TABLES_H__
+
+#include <stdint.h>
+
+namespace LibCrcTables {
+
+/* CRC15 (PEC) --------------------------------------------------------------*/
+constexpr uint16_t kCrc15Poly = 0x4599u;   /* x15 + x14 + x10 + x8 + x7 + x4 + x3 + 1 */
+constexpr uint16_t kCrc15Seed = 16u;
+
+// Same contents as Crc15Table[], widened to 32 bits so it can be used as a
+// gather table by the SIMD batch engine.
+struct Crc15Tables
+{
+    uint32_t Table[256];
+};
+
+constexpr Crc15Tables makeCrc15Tables()
+{
+    Crc15Tables tables{};
+    for (int i = 0; i < 256; ++i) {
+        uint16_t nRemainder = static_cast<uint16_t>(i << 7);
+        for (int nBit = 8; nBit > 0; --nBit) {
+            if ((nRemainder & 0x4000u) != 0u)
+                nRemainder = static_cast<uint16_t>((nRemainder << 1u) ^ kCrc15Poly);
+            else
+                nRemainder = static_cast<uint16_t>(nRemainder << 1u);
+        }
+        tables.Table[i] = nRemainder;
+    }
+    return tables;
+}
+
+inline constexpr Crc15Tables kCrc15 = makeCrc15Tables();
+
+static_assert(kCrc15.Table[0x01] == 0xC599, "Crc15Table[1] mismatch");
+static_assert(kCrc15.Table[0xFF] == 0x8095, "Crc15Table[255] mismatch");
+
+/* CRC10 (DPEC) -------------------------------------------------------------*/
+constexpr uint16_t kCrc10Poly = 0x8Fu;     /* x10 + x7 + x3 + x2 + x + 1 */
+constexpr uint16_t kCrc10Seed = 16u;       /* PEC_SEED */
+constexpr uint16_t kCrc10Mask = 0x3FFu;
+
+/* Shift the 10-bit remainder nBits times through the polynomial */
+constexpr uint16_t crc10Shift(uint16_t nRemainder, int nBits)
+{
+    for (int i = 0; i < nBits; ++i) {
+        if ((nRemainder & 0x200u) != 0u)
+            nRemainder = static_cast<uint16_t>(((nRemainder << 1u) ^ kCrc10Poly) & kCrc10Mask);
+        else
+            nRemainder = static_cast<uint16_t>((nRemainder << 1u) & kCrc10Mask);
+    }
+    return nRemainder;
+}
+
+// Slice[k][i] = remainder of byte i followed by k zero bytes (Slice[0] is the
+// classic crc10Table). Tail[i] = 6-bit command-counter step for index i.
+struct Crc10Tables
+{
+    uint16_t Slice[8][256];
+    uint16_t Tail[64];
+    uint32_t Wide[256];        /* Slice[0] widened for SIMD gathers */
+    uint32_t WideTail[64];     /* Tail widened for SIMD gathers */
+};
+
+constexpr Crc10Tables makeCrc10Tables()
+{
+    Crc10Tables tables{};
+    for (int i = 0; i < 256; ++i)
+        tables.Slice[0][i] = crc10Shift(static_cast<uint16_t>(i << 2), 8);
+    for (int k = 1; k < 8; ++k)
+        for (int i = 0; i < 256; ++i)
+            tables.Slice[k][i] = crc10Shift(tables.Slice[k - 1][i], 8);
+    for (int i = 0; i < 64; ++i)
+        tables.Tail[i] = crc10Shift(static_cast<uint16_t>(i << 4), 6);
+    for (int i = 0; i < 256; ++i)
+        tables.Wide[i] = tables.Slice[0][i];
+    for (int i = 0; i < 64; ++i)
+        tables.WideTail[i] = tables.Tail[i];
+    return tables;
+}
+
+inline constexpr Crc10Tables kCrc10 = makeCrc10Tables();
+
+/* Spot checks against the previous hand-written crc10Table */
+static_assert(kCrc10.Slice[0][0x01] == 0x08F, "crc10Table[1] mismatch");
+static_assert(kCrc10.Slice[0][0x80] == 0x2E1, "crc10Table[128] mismatch");
+static_assert(kCrc10.Slice[0][0xFF] == 0x0BE, "crc10Table[255] mismatch");
+
+/* Compile-time DPEC, same result as pec10_calc() */
+constexpr uint16_t pec10Const(const uint8_t *pData, int nLength, bool blSrXCmd = false, uint8_t u8CmdCnt = 0)
+{
+    uint16_t nRemainder = kCrc10Seed;
+    for (int i = 0; i < nLength; ++i)
+        nRemainder = static_cast<uint16_t>(((nRemainder & 0x03u) << 8u)
+                                           ^ kCrc10.Slice[0][((nRemainder >> 2u) ^ pData[i]) & 0xFFu]);
+    uint16_t nIndex = static_cast<uint16_t>(nRemainder >> 4u);
+    if (blSrXCmd)
+        nIndex ^= static_cast<uint16_t>(u8CmdCnt >> 2u);
+    return static_cast<uint16_t>((((nRemainder & 0x0Fu) << 6u) ^ kCrc10.Tail[nIndex & 0x3Fu]) & kCrc10Mask);
+}
+
+} // namespace LibCrcTables
+
+#endif
@@ -0,0 +1,282 @@
+/*
+******************************************************************************
+* @file     LibPecBatchCalc.cpp
+* @author   Golden Chen
+* @brief    Multi-buffer CRC15(PEC) / CRC10(DPEC) calculation for AFE chains
+
+******************************************************************************
+* @attention
+*
+* COPYRIGHT(c) 2025 FW Team</center>
+******************************************************************************
+*/
+
+#include "LibPecBatchCalc.h"
+#include "LibCrc15Crc10TableCalc.h"
+#include "LibCrcTables.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  if defined(__GNUC__) || defined(__clang__)
+#    define PEC_BATCH_HAVE_AVX2     1
+#    define PEC_AVX2_TARGET         __attribute__((target("avx2")))
+#    include <immintrin.h>
+#  elif defined(_MSC_VER)
+#    define PEC_BATCH_HAVE_AVX2     1
+#    define PEC_AVX2_TARGET
+#    include <immintrin.h>
+#    include <intrin.h>
+#  endif
+#endif
+
+/* Local define -------------------------------------------------------------*/
+namespace {
+
+using LibCrcTables::kCrc10;
+using LibCrcTables::kCrc10Mask;
+using LibCrcTables::kCrc10Seed;
+using LibCrcTables::kCrc15;
+using LibCrcTables::kCrc15Seed;
+
+std::atomic<int> g_eEngine(PEC_BATCH_ENGINE_AUTO);
+
+/* Scalar engine ------------------------------------------------------------*/
+// Four independent CRC chains per iteration. Each chain is a serial table
+// walk, so running four side by side lets their loads overlap.
+
+inline uint32_t crc15Step(uint32_t nRemainder, uint8_t u8Data)
+{
+    return ((nRemainder << 8u) ^ kCrc15.Table[((nRemainder >> 7u) ^ u8Data) & 0xFFu]) & 0xFFFFu;
+}
+
+inline uint32_t crc10Step(uint32_t nRemainder, uint8_t u8Data)
+{
+    return ((nRemainder & 0x03u) << 8u) ^ kCrc10.Wide[((nRemainder >> 2u) ^ u8Data) & 0xFFu];
+}
+
+inline uint16_t crc10Tail(uint32_t nRemainder, bool blSrXCmd, uint8_t u8CmdCnt)
+{
+    uint32_t nIndex = nRemainder >> 4u;
+    if (blSrXCmd)
+        nIndex ^= static_cast<uint32_t>(u8CmdCnt >> 2u);
+    return static_cast<uint16_t>((((nRemainder & 0x0Fu) << 6u) ^ kCrc10.WideTail[nIndex & 0x3Fu]) & kCrc10Mask);
+}
+
+void crc15BatchScalar(uint8_t len, const uint8_t *pData, size_t nStride, size_t nBegin, size_t nCount, uint16_t *pResult)
+{
+    size_t k = nBegin;
+    for (; k + 4 <= nCount; k += 4) {
+        const uint8_t *p0 = pData + k * nStride;
+        const uint8_t *p1 = p0 + nStride;
+        const uint8_t *p2 = p1 + nStride;
+        const uint8_t *p3 = p2 + nStride;
+        uint32_t r0 = kCrc15Seed, r1 = kCrc15Seed, r2 = kCrc15Seed, r3 = kCrc15Seed;
+        for (uint8_t i = 0; i < len; ++i) {
+            r0 = crc15Step(r0, p0[i]);
+            r1 = crc15Step(r1, p1[i]);
+            r2 = crc15Step(r2, p2[i]);
+            r3 = crc15Step(r3, p3[i]);
+        }
+        pResult[k]     = static_cast<uint16_t>(r0 * 2u);
+        pResult[k + 1] = static_cast<uint16_t>(r1 * 2u);
+        pResult[k + 2] = static_cast<uint16_t>(r2 * 2u);
+        pResult[k + 3] = static_cast<uint16_t>(r3 * 2u);
+    }
+    for (; k < nCount; ++k) {
+        const uint8_t *p = pData + k * nStride;
+        uint32_t r = kCrc15Seed;
+        for (uint8_t i = 0; i < len; ++i)
+            r = crc15Step(r, p[i]);
+        pResult[k] = static_cast<uint16_t>(r * 2u);
+    }
+}
+
+void crc10BatchScalar(bool blSrXCmd, int nLength, const uint8_t *pData, size_t nStride, size_t nBegin, size_t nCount, uint16_t *pResult)
+{
+    size_t k = nBegin;
+    for (; k + 4 <= nCount; k += 4) {
+        const uint8_t *p0 = pData + k * nStride;
+        const uint8_t *p1 = p0 + nStride;
+        const uint8_t *p2 = p1 + nStride;
+        const uint8_t *p3 = p2 + nStride;
+        uint32_t r0 = kCrc10Seed, r1 = kCrc10Seed, r2 = kCrc10Seed, r3 = kCrc10Seed;
+        for (int i = 0; i < nLength; ++i) {
+            r0 = crc10Step(r0, p0[i]);
+            r1 = crc10Step(r1, p1[i]);
+            r2 = crc10Step(r2, p2[i]);
+            r3 = crc10Step(r3, p3[i]);
+        }
+        pResult[k]     = crc10Tail(r0, blSrXCmd, blSrXCmd ? p0[nLength] : 0);
+        pResult[k + 1] = crc10Tail(r1, blSrXCmd, blSrXCmd ? p1[nLength] : 0);
+        pResult[k + 2] = crc10Tail(r2, blSrXCmd, blSrXCmd ? p2[nLength] : 0);
+        pResult[k + 3] = crc10Tail(r3, blSrXCmd, blSrXCmd ? p3[nLength] : 0);
+    }
+    for (; k < nCount; ++k) {
+        const uint8_t *p = pData + k * nStride;
+        uint32_t r = kCrc10Seed;
+        for (int i = 0; i < nLength; ++i)
+            r = crc10Step(r, p[i]);
+        pResult[k] = crc10Tail(r, blSrXCmd, blSrXCmd ? p[nLength] : 0);
+    }
+}
+
+/* AVX2 engine --------------------------------------------------------------*/
+// Eight chains, one per 32-bit lane. Table lookups become vpgatherdd; the
+// frame bytes are loaded per lane since frames are not contiguous columns.
+// A carry-less multiply (PCLMUL) fold only pays off for long buffers; the
+// 6-byte register groups are far too short for it, so it is not used here.
+#if defined(PEC_BATCH_HAVE_AVX2)
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7)
+        return false;
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+PEC_AVX2_TARGET
+inline __m256i loadColumn(const uint8_t *p, size_t nStride, int i)
+{
+    return _mm256_setr_epi32(p[i], p[nStride + i], p[2 * nStride + i], p[3 * nStride + i],
+                             p[4 * nStride + i], p[5 * nStride + i], p[6 * nStride + i], p[7 * nStride + i]);
+}
+
+PEC_AVX2_TARGET
+size_t crc15BatchAvx2(uint8_t len, const uint8_t *pData, size_t nStride, size_t nCount, uint16_t *pResult)
+{
+    const __m256i vMask8 = _mm256_set1_epi32(0xFF);
+    const __m256i vMask16 = _mm256_set1_epi32(0xFFFF);
+    const int *pTable = reinterpret_cast<const int *>(kCrc15.Table);
+    alignas(32) uint32_t u32Lane[8];
+
+    size_t k = 0;
+    for (; k + 8 <= nCount; k += 8) {
+        const uint8_t *p = pData + k * nStride;
+        __m256i vRem = _mm256_set1_epi32(kCrc15Seed);
+        for (int i = 0; i < len; ++i) {
+            __m256i vAddr = _mm256_and_si256(_mm256_xor_si256(_mm256_srli_epi32(vRem, 7), loadColumn(p, nStride, i)), vMask8);
+            __m256i vTab = _mm256_i32gather_epi32(pTable, vAddr, 4);
+            vRem = _mm256_and_si256(_mm256_xor_si256(_mm256_slli_epi32(vRem, 8), vTab), vMask16);
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i *>(u32Lane), _mm256_slli_epi32(vRem, 1));
+        for (int j = 0; j < 8; ++j)
+            pResult[k + j] = static_cast<uint16_t>(u32Lane[j]);
+    }
+    return k;
+}
+
+PEC_AVX2_TARGET
+size_t crc10BatchAvx2(bool blSrXCmd, int nLength, const uint8_t *pData, size_t nStride, size_t nCount, uint16_t *pResult)
+{
+    const __m256i vMask2 = _mm256_set1_epi32(0x03);
+    const __m256i vMask4 = _mm256_set1_epi32(0x0F);
+    const __m256i vMask6 = _mm256_set1_epi32(0x3F);
+    const __m256i vMask8 = _mm256_set1_epi32(0xFF);
+    const __m256i vMask10 = _mm256_set1_epi32(kCrc10Mask);
+    const int *pTable = reinterpret_cast<const int *>(kCrc10.Wide);
+    const int *pTail = reinterpret_cast<const int *>(kCrc10.WideTail);
+    alignas(32) uint32_t u32Lane[8];
+
+    size_t k = 0;
+    for (; k + 8 <= nCount; k += 8) {
+        const uint8_t *p = pData + k * nStride;
+        __m256i vRem = _mm256_set1_epi32(kCrc10Seed);
+        for (int i = 0; i < nLength; ++i) {
+            __m256i vAddr = _mm256_and_si256(_mm256_xor_si256(_mm256_srli_epi32(vRem, 2), loadColumn(p, nStride, i)), vMask8);
+            __m256i vTab = _mm256_i32gather_epi32(pTable, vAddr, 4);
+            vRem = _mm256_xor_si256(_mm256_slli_epi32(_mm256_and_si256(vRem, vMask2), 8), vTab);
+        }
+
+        __m256i vIndex = _mm256_srli_epi32(vRem, 4);
+        if (blSrXCmd)
+            vIndex = _mm256_xor_si256(vIndex, _mm256_srli_epi32(loadColumn(p, nStride, nLength), 2));
+        vIndex = _mm256_and_si256(vIndex, vMask6);
+        __m256i vTail = _mm256_i32gather_epi32(pTail, vIndex, 4);
+        vRem = _mm256_xor_si256(_mm256_slli_epi32(_mm256_and_si256(vRem, vMask4), 6), vTail);
+        vRem = _mm256_and_si256(vRem, vMask10);
+
+        _mm256_store_si256(reinterpret_cast<__m256i *>(u32Lane), vRem);
+        for (int j = 0; j < 8; ++j)
+            pResult[k + j] = static_cast<uint16_t>(u32Lane[j]);
+    }
+    return k;
+}
+
+#endif
+
+PecBatchEngine_t resolveEngine()
+{
+    PecBatchEngine_t eEngine = static_cast<PecBatchEngine_t>(g_eEngine.load(std::memory_order_relaxed));
+#if defined(PEC_BATCH_HAVE_AVX2)
+    static const bool s_blAvx2 = cpuHasAvx2();
+    if (eEngine == PEC_BATCH_ENGINE_AUTO)
+        return s_blAvx2 ? PEC_BATCH_ENGINE_AVX2 : PEC_BATCH_ENGINE_SCALAR;
+    if (eEngine == PEC_BATCH_ENGINE_AVX2 && !s_blAvx2)
+        return PEC_BATCH_ENGINE_SCALAR;
+    return eEngine;
+#else
+    (void)eEngine;
+    return PEC_BATCH_ENGINE_SCALAR;
+#endif
+}
+
+} // namespace
+
+/* Global functions ---------------------------------------------------------*/
+
+void Pec15_CalcBatch(uint8_t len, const uint8_t *pData, size_t nStride, size_t nCount, uint16_t *pResult)
+{
+    size_t nDone = 0;
+#if defined(PEC_BATCH_HAVE_AVX2)
+    if (resolveEngine() == PEC_BATCH_ENGINE_AVX2)
+        nDone = crc15BatchAvx2(len, pData, nStride, nCount, pResult);
+#endif
+    crc15BatchScalar(len, pData, nStride, nDone, nCount, pResult);
+}
+
+void pec10_calc_batch(bool blSrXCmd, int nLength, const uint8_t *pData, size_t nStride, size_t nCount, uint16_t *pResult)
+{
+    if (nLength < 0)
+        nLength = 0;
+
+    size_t nDone = 0;
+#if defined(PEC_BATCH_HAVE_AVX2)
+    if (resolveEngine() == PEC_BATCH_ENGINE_AVX2)
+        nDone = crc10BatchAvx2(blSrXCmd, nLength, pData, nStride, nCount, pResult);
+#endif
+    crc10BatchScalar(blSrXCmd, nLength, pData, nStride, nDone, nCount, pResult);
+}
+
+void PecBatch_SetEngine(PecBatchEngine_t eEngine)
+{
+    g_eEngine.store(eEngine, std::memory_order_relaxed);
+}
+
+PecBatchEngine_t PecBatch_GetEngine(void)
+{
+    return resolveEngine();
+}
+
+const char *PecBatch_EngineName(PecBatchEngine_t eEngine)
+{
+    switch (eEngine) {
+    case PEC_BATCH_ENGINE_AUTO:   return "auto";
+    case PEC_BATCH_ENGINE_SCALAR: return "scalar-x4";
+    case PEC_BATCH_ENGINE_AVX2:   return "avx2-x8";
+    }
+    return "unknown";
+}
@@ -0,0 +1,53 @@
+/*
+******************************************************************************
+* @file     LibPecBatchCalc.h
+* @author   Golden Chen
+* @brief    Multi-buffer CRC15(PEC) / CRC10(DPEC) calculation for AFE chains
+
+******************************************************************************
+* @attention
+*
+* COPYRIGHT(c) 2025 FW Team</center>
+******************************************************************************
+*/
+#ifndef __LIB_PEC_BATCH_CALC_H__
+#define	__LIB_PEC_BATCH_CALC_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+/* Global define ------------------------------------------------------------*/
+/* Global typedef -----------------------------------------------------------*/
+typedef enum
+{
+    PEC_BATCH_ENGINE_AUTO = 0,     /* best engine supported by this CPU */
+    PEC_BATCH_ENGINE_SCALAR,       /* 4 interleaved chains, portable */
+    PEC_BATCH_ENGINE_AVX2          /* 8 chains per AVX2 register (x86-64) */
+} PecBatchEngine_t;
+
+/* Global macro -------------------------------------------------------------*/
+/* Global function prototypes -----------------------------------------------*/
+
+// nCount frames of nLength bytes each, frame k starting at pData + k*nStride.
+// pResult[k] receives the same value as Pec15_Calc / pec10_calc on frame k.
+// For pec10 with blSrXCmd the command counter byte follows each frame, so
+// nStride must be >= nLength + 1.
+void Pec15_CalcBatch(uint8_t len, const uint8_t *pData, size_t nStride, size_t nCount, uint16_t *pResult);
+void pec10_calc_batch(bool blSrXCmd, int nLength, const uint8_t *pData, size_t nStride, size_t nCount, uint16_t *pResult);
+
+/* Engine selection (runtime dispatch, default AUTO) */
+void PecBatch_SetEngine(PecBatchEngine_t eEngine);
+PecBatchEngine_t PecBatch_GetEngine(void);
+const char *PecBatch_EngineName(PecBatchEngine_t eEngine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
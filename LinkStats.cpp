@@ -0,0 +1,73 @@
+#include "LinkStats.h"
+
+#include <chrono>
+#include <cstdio>
+
+void LinkStats::reset()
+{
+    for (Counter *c : {&txBytes, &txFrames, &rxBytes, &rxFrames, &checksumErrors, &dpecErrors,
+                       &resyncs, &garbageBytes, &partialFlushes, &partialBytes, &holdExpired,
+                       &rxOverflows, &txBacklog, &txQueued, &txQueueNs})
+        c->store(0, std::memory_order_relaxed);
+}
+
+LinkSnapshot LinkStats::snapshot() const
+{
+    LinkSnapshot s;
+    s.timeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    s.txBytes = txBytes.load(std::memory_order_relaxed);
+    s.txFrames = txFrames.load(std::memory_order_relaxed);
+    s.rxBytes = rxBytes.load(std::memory_order_relaxed);
+    s.rxFrames = rxFrames.load(std::memory_order_relaxed);
+    s.checksumErrors = checksumErrors.load(std::memory_order_relaxed);
+    s.dpecErrors = dpecErrors.load(std::memory_order_relaxed);
+    s.resyncs = resyncs.load(std::memory_order_relaxed);
+    s.garbageBytes = garbageBytes.load(std::memory_order_relaxed);
+    s.partialFlushes = partialFlushes.load(std::memory_order_relaxed);
+    s.partialBytes = partialBytes.load(std::memory_order_relaxed);
+    s.holdExpired = holdExpired.load(std::memory_order_relaxed);
+    s.rxOverflows = rxOverflows.load(std::memory_order_relaxed);
+    s.txBacklog = txBacklog.load(std::memory_order_relaxed);
+    s.txQueued = txQueued.load(std::memory_order_relaxed);
+    s.txQueueNs = txQueueNs.load(std::memory_order_relaxed);
+    return s;
+}
+
+LinkRates LinkStats::rates(const LinkSnapshot &prev, const LinkSnapshot &cur)
+{
+    LinkRates r;
+    if (cur.timeNs <= prev.timeNs)
+        return r;
+
+    // 計數器在開埠時歸零，小於前一次就當作從 0 開始
+    auto delta = [](uint64_t a, uint64_t b) { return static_cast<double>(b >= a ? b - a : b); };
+    const double sec = static_cast<double>(cur.timeNs - prev.timeNs) / 1e9;
+    r.txBytesPerSec = delta(prev.txBytes, cur.txBytes) / sec;
+    r.txFramesPerSec = delta(prev.txFrames, cur.txFrames) / sec;
+    r.rxBytesPerSec = delta(prev.rxBytes, cur.rxBytes) / sec;
+    r.rxFramesPerSec = delta(prev.rxFrames, cur.rxFrames) / sec;
+    const double frames = delta(prev.txFrames, cur.txFrames);
+    if (frames > 0.0)
+        r.txQueueAvgUs = delta(prev.txQueueNs, cur.txQueueNs) / frames / 1e3;
+    return r;
+}
+
+std::string LinkStats::describe(const LinkSnapshot &s, const LinkRates &r)
+{
+    char line[320];
+    std::snprintf(line, sizeof(line),
+                  "TX %.0f B/s %.0f f/s | RX %.0f B/s %.0f f/s | CHK %llu DPEC %llu RESYNC %llu "
+                  "PART %llu %lluB HOLD %llu DROP %llu | Backlog %llu B Queue %llu %.0f us",
+                  r.txBytesPerSec, r.txFramesPerSec, r.rxBytesPerSec, r.rxFramesPerSec,
+                  static_cast<unsigned long long>(s.checksumErrors),
+                  static_cast<unsigned long long>(s.dpecErrors),
+                  static_cast<unsigned long long>(s.resyncs),
+                  static_cast<unsigned long long>(s.partialFlushes),
+                  static_cast<unsigned long long>(s.partialBytes),
+                  static_cast<unsigned long long>(s.holdExpired),
+                  static_cast<unsigned long long>(s.rxOverflows),
+                  static_cast<unsigned long long>(s.txBacklog),
+                  static_cast<unsigned long long>(s.txQueued), r.txQueueAvgUs);
+    return line;
+}
@@ -0,0 +1,77 @@
+#ifndef LINKSTATS_H
+#define LINKSTATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Serial link counters.
+//
+// Written by one thread only (the serial I/O thread), read by anyone. With a
+// single writer an update is a relaxed load + store, so the hot path pays no
+// locked instruction; readers take a snapshot() and turn two snapshots into
+// rates.
+struct LinkSnapshot
+{
+    uint64_t timeNs = 0;            // monotonic
+    uint64_t txBytes = 0;
+    uint64_t txFrames = 0;
+    uint64_t rxBytes = 0;
+    uint64_t rxFrames = 0;
+    uint64_t checksumErrors = 0;
+    uint64_t dpecErrors = 0;
+    uint64_t resyncs = 0;
+    uint64_t garbageBytes = 0;
+    uint64_t partialFlushes = 0;    // partial frames flushed after an RX line gap
+    uint64_t partialBytes = 0;
+    uint64_t holdExpired = 0;       // of those, flushed at the max hold, line still busy
+    uint64_t rxOverflows = 0;       // RX records lost, consumer too slow
+    uint64_t txBacklog = 0;         // bytes pending in the OS / QSerialPort
+    uint64_t txQueued = 0;          // records waiting in the TX lanes
+    uint64_t txQueueNs = 0;         // total time frames spent in the TX lanes
+};
+
+struct LinkRates
+{
+    double txBytesPerSec = 0.0;
+    double txFramesPerSec = 0.0;
+    double rxBytesPerSec = 0.0;
+    double rxFramesPerSec = 0.0;
+    double txQueueAvgUs = 0.0;      // mean time in the TX lanes of the frames written
+};
+
+class LinkStats
+{
+public:
+    using Counter = std::atomic<uint64_t>;
+
+    // Writer thread only
+    static void add(Counter &c, uint64_t n) { c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    static void set(Counter &c, uint64_t v) { c.store(v, std::memory_order_relaxed); }
+
+    void reset();
+    LinkSnapshot snapshot() const;
+
+    static LinkRates rates(const LinkSnapshot &prev, const LinkSnapshot &cur);
+
+    // One line for the status bar / headless output
+    static std::string describe(const LinkSnapshot &s, const LinkRates &r);
+
+    Counter txBytes{0};
+    Counter txFrames{0};
+    Counter rxBytes{0};
+    Counter rxFrames{0};
+    Counter checksumErrors{0};
+    Counter dpecErrors{0};
+    Counter resyncs{0};
+    Counter garbageBytes{0};
+    Counter partialFlushes{0};
+    Counter partialBytes{0};
+    Counter holdExpired{0};
+    Counter rxOverflows{0};
+    Counter txBacklog{0};
+    Counter txQueued{0};
+    Counter txQueueNs{0};
+};
+
+#endif // LINKSTATS_H
@@ -0,0 +1,94 @@
+#include "PlotPanel.h"
+
+#include <QHBoxLayout>
+#include <QSplitter>
+#include <QVBoxLayout>
+
+#include "EmuProtocol.h"
+#include "PortManager.h"
+
+#define APP_PLOT_REFRESH_INTERVAL   (100)   //ms
+#define APP_PLOT_AFE_RANGE_MAX      (16)    //同時畫出的 AFE 數 (x18 cells)
+
+PlotPanel::PlotPanel(const ReadbackPanel *source, QWidget *parent)
+    : QWidget(parent)
+    , source(source)
+    , spinPort(new QSpinBox(this))
+    , spinFirstAfe(new QSpinBox(this))
+    , spinAfeCount(new QSpinBox(this))
+    , spinWindow(new QDoubleSpinBox(this))
+    , checkPause(new QCheckBox("Pause", this))
+    , labelInfo(new QLabel(this))
+    , series(new TimeSeriesView(this))
+    , heatMap(new ChainHeatMap(this))
+    , refreshTimer(new QTimer(this))
+{
+    spinPort->setRange(0, PortManager::kMaxPorts - 1);
+    spinPort->setPrefix("P");
+    spinFirstAfe->setRange(1, APP_AFECASE_NUM_MAX);
+    spinFirstAfe->setPrefix("AFE");
+    spinAfeCount->setRange(1, APP_PLOT_AFE_RANGE_MAX);
+    spinWindow->setRange(0.1, 3600.0);
+    spinWindow->setDecimals(1);
+    spinWindow->setValue(10.0);
+    spinWindow->setSuffix(" s");
+
+    QHBoxLayout *top = new QHBoxLayout();
+    top->addWidget(new QLabel("Port", this));
+    top->addWidget(spinPort);
+    top->addWidget(new QLabel("From", this));
+    top->addWidget(spinFirstAfe);
+    top->addWidget(new QLabel("Count", this));
+    top->addWidget(spinAfeCount);
+    top->addWidget(new QLabel("Window", this));
+    top->addWidget(spinWindow);
+    top->addWidget(checkPause);
+    top->addWidget(labelInfo, 1);
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(series);
+    splitter->addWidget(heatMap);
+    splitter->setStretchFactor(0, 3);
+    splitter->setStretchFactor(1, 2);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(top);
+    layout->addWidget(splitter, 1);
+
+    connect(spinPort, QOverload<int>::of(&QSpinBox::valueChanged), this, &PlotPanel::onSelectionChanged);
+    connect(spinFirstAfe, QOverload<int>::of(&QSpinBox::valueChanged), this, &PlotPanel::onSelectionChanged);
+    connect(spinAfeCount, QOverload<int>::of(&QSpinBox::valueChanged), this, &PlotPanel::onSelectionChanged);
+    connect(spinWindow, QOverload<double>::of(&QDoubleSpinBox::valueChanged), series, &TimeSeriesView::setWindow);
+    connect(heatMap, &ChainHeatMap::afeClicked, this, &PlotPanel::onAfeClicked);
+
+    // 只在分頁可見且未暫停時重畫；繪圖成本只跟畫面寬度有關
+    refreshTimer->setInterval(APP_PLOT_REFRESH_INTERVAL);
+    connect(refreshTimer, &QTimer::timeout, this, &PlotPanel::onRefresh);
+    refreshTimer->start();
+
+    series->setWindow(spinWindow->value());
+    onSelectionChanged();
+}
+
+void PlotPanel::onSelectionChanged()
+{
+    const int port = spinPort->value();
+    series->setSource(&source->history(port));
+    series->setAfes(spinFirstAfe->value() - 1, spinAfeCount->value());
+    heatMap->setSource(&source->decoder(port));
+}
+
+void PlotPanel::onAfeClicked(int afe)
+{
+    spinFirstAfe->setValue(afe + 1);
+}
+
+void PlotPanel::onRefresh()
+{
+    if (!isVisible() || checkPause->isChecked())
+        return;
+    const EmuRegisterDecoder &d = source->decoder(spinPort->value());
+    labelInfo->setText(QString("AFEs %1, records %2").arg(d.afeCount()).arg(d.stats().records));
+    series->update();
+    heatMap->update();
+}
@@ -0,0 +1,44 @@
+#ifndef PLOTPANEL_H
+#define PLOTPANEL_H
+
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QSpinBox>
+#include <QTimer>
+#include <QWidget>
+
+#include "PlotViews.h"
+#include "ReadbackPanel.h"
+
+// "Plot" tab: live cell voltages of the selected port, drawn from the
+// decoder / history owned by the Readback tab. The time series shows all
+// cells of a range of AFEs over a time window, the heat map the latest
+// value of every cell of the chain; clicking a row of the heat map moves
+// the time series to that AFE.
+class PlotPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PlotPanel(const ReadbackPanel *source, QWidget *parent = nullptr);
+
+private slots:
+    void onSelectionChanged();
+    void onAfeClicked(int afe);
+    void onRefresh();
+
+private:
+    const ReadbackPanel *source;
+    QSpinBox *spinPort;
+    QSpinBox *spinFirstAfe;
+    QSpinBox *spinAfeCount;
+    QDoubleSpinBox *spinWindow;
+    QCheckBox *checkPause;
+    QLabel *labelInfo;
+    TimeSeriesView *series;
+    ChainHeatMap *heatMap;
+    QTimer *refreshTimer;
+};
+
+#endif // PLOTPANEL_H
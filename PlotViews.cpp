@@ -0,0 +1,206 @@
+#include "PlotViews.h"
+
+#include <QImage>
+#include <QLineF>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int kMarginLeft = 56;     // px, Y axis labels
+constexpr int kMarginBottom = 18;   // px, time axis labels
+constexpr int kMargin = 6;
+
+QColor traceColor(int trace)
+{
+    // 18 個 cell 各一個色相，相鄰 AFE 明暗交錯
+    return QColor::fromHsv((trace % EmuCellHistory::kCellChannels) * 20, 220, (trace / EmuCellHistory::kCellChannels) % 2 ? 160 : 230);
+}
+
+QRgb heatColor(double t)
+{
+    // 0 藍 -> 0.5 綠 -> 1 紅
+    t = std::min(std::max(t, 0.0), 1.0);
+    const int r = static_cast<int>(255.0 * std::min(std::max(2.0 * t - 1.0, 0.0), 1.0));
+    const int b = static_cast<int>(255.0 * std::min(std::max(1.0 - 2.0 * t, 0.0), 1.0));
+    const int g = 255 - r - b;
+    return qRgb(r, g, b);
+}
+
+} // namespace
+
+/* Time series --------------------------------------------------------------*/
+TimeSeriesView::TimeSeriesView(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumHeight(160);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void TimeSeriesView::setSource(const EmuCellHistory *history)
+{
+    source = history;
+    update();
+}
+
+void TimeSeriesView::setAfes(int first, int count)
+{
+    firstAfe = std::max(first, 0);
+    afeCount = std::max(count, 1);
+    update();
+}
+
+void TimeSeriesView::setWindow(double seconds)
+{
+    windowNs = static_cast<uint64_t>(std::max(seconds, 0.001) * 1e9);
+    update();
+}
+
+void TimeSeriesView::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    const QRect plot = rect().adjusted(kMarginLeft, kMargin, -kMargin, -kMarginBottom);
+    painter.setPen(palette().mid().color());
+    painter.drawRect(plot);
+    if (!source || source->latestNs() == 0 || plot.width() < 2 || plot.height() < 2)
+        return;
+
+    // 1. Decimate every trace to one min/max per pixel column
+    const int buckets = plot.width();
+    const int traces = afeCount * EmuCellHistory::kCellChannels;
+    const uint64_t to = source->latestNs() + 1;
+    const uint64_t from = to - std::min(to, windowNs);
+    minV.resize(static_cast<size_t>(traces) * static_cast<size_t>(buckets));
+    maxV.resize(minV.size());
+
+    float lo = INFINITY, hi = -INFINITY;
+    for (int t = 0; t < traces; ++t) {
+        float *mn = &minV[static_cast<size_t>(t) * static_cast<size_t>(buckets)];
+        float *mx = &maxV[static_cast<size_t>(t) * static_cast<size_t>(buckets)];
+        source->decimate(firstAfe + t / EmuCellHistory::kCellChannels, t % EmuCellHistory::kCellChannels,
+                         from, to, buckets, mn, mx);
+        for (int b = 0; b < buckets; ++b) {
+            if (!std::isnan(mn[b])) {
+                lo = std::min(lo, mn[b]);
+                hi = std::max(hi, mx[b]);
+            }
+        }
+    }
+    if (!(lo <= hi))
+        return;     // nothing in the window
+    if (hi - lo < 0.001f) {
+        lo -= 0.0005f;
+        hi += 0.0005f;
+    }
+
+    // 2. One vertical segment per bucket, joined to the previous bucket
+    const double scale = (plot.height() - 1) / static_cast<double>(hi - lo);
+    auto y = [&](float v) { return plot.bottom() - (v - lo) * scale; };
+    QVector<QLineF> lines;
+    lines.reserve(buckets * 2);
+    for (int t = 0; t < traces; ++t) {
+        const float *mn = &minV[static_cast<size_t>(t) * static_cast<size_t>(buckets)];
+        const float *mx = &maxV[static_cast<size_t>(t) * static_cast<size_t>(buckets)];
+        lines.clear();
+        int prev = -1;
+        for (int b = 0; b < buckets; ++b) {
+            if (std::isnan(mn[b]))
+                continue;
+            const double x = plot.left() + b;
+            lines.append(QLineF(x, y(mn[b]), x, y(mx[b])));
+            if (prev >= 0)
+                lines.append(QLineF(plot.left() + prev, y((mn[prev] + mx[prev]) / 2), x, y((mn[b] + mx[b]) / 2)));
+            prev = b;
+        }
+        painter.setPen(traceColor(t));
+        painter.drawLines(lines);
+    }
+
+    // 3. Axes
+    painter.setPen(palette().text().color());
+    painter.drawText(QRect(0, plot.top() - 2, kMarginLeft - 4, 16), Qt::AlignRight, QString::number(hi, 'f', 4));
+    painter.drawText(QRect(0, plot.bottom() - 14, kMarginLeft - 4, 16), Qt::AlignRight, QString::number(lo, 'f', 4));
+    painter.drawText(QRect(plot.left(), plot.bottom() + 2, plot.width(), kMarginBottom - 2), Qt::AlignLeft,
+                     QString("-%1 s").arg(static_cast<double>(windowNs) / 1e9, 0, 'g', 4));
+    painter.drawText(QRect(plot.left(), plot.bottom() + 2, plot.width(), kMarginBottom - 2), Qt::AlignRight, "now");
+}
+
+/* Heat map -----------------------------------------------------------------*/
+ChainHeatMap::ChainHeatMap(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumHeight(120);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void ChainHeatMap::setSource(const EmuRegisterDecoder *decoder)
+{
+    source = decoder;
+    update();
+}
+
+QRect ChainHeatMap::mapRect() const
+{
+    return rect().adjusted(kMarginLeft, kMargin, -kMargin, -kMarginBottom);
+}
+
+void ChainHeatMap::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    const QRect area = mapRect();
+    const int afes = source ? source->afeCount() : 0;
+    const int cells = EmuRegisterDecoder::kCellChannels;
+    if (afes == 0 || area.width() < 2 || area.height() < 2)
+        return;
+
+    double lo = INFINITY, hi = -INFINITY;
+    for (int c = 0; c < cells; ++c) {
+        const double *v = source->cellVolts(c);
+        for (int afe = 0; afe < afes; ++afe) {
+            if (!std::isnan(v[afe])) {
+                lo = std::min(lo, v[afe]);
+                hi = std::max(hi, v[afe]);
+            }
+        }
+    }
+    const double span = (hi > lo) ? hi - lo : 1.0;
+
+    // 一個像素一個 cell，再整張縮放到畫面
+    QImage image(cells, afes, QImage::Format_RGB32);
+    for (int afe = 0; afe < afes; ++afe) {
+        QRgb *row = reinterpret_cast<QRgb *>(image.scanLine(afe));
+        for (int c = 0; c < cells; ++c) {
+            const double v = source->cellVolts(c)[afe];
+            row[c] = std::isnan(v) ? qRgb(128, 128, 128) : heatColor((v - lo) / span);
+        }
+    }
+    painter.drawImage(area, image);
+
+    painter.setPen(palette().text().color());
+    painter.drawText(QRect(0, area.top() - 2, kMarginLeft - 4, 16), Qt::AlignRight, "AFE1");
+    painter.drawText(QRect(0, area.bottom() - 14, kMarginLeft - 4, 16), Qt::AlignRight, QString("AFE%1").arg(afes));
+    if (lo <= hi) {
+        painter.drawText(QRect(area.left(), area.bottom() + 2, area.width(), kMarginBottom - 2), Qt::AlignLeft,
+                         QString("C1   blue %1 V").arg(lo, 0, 'f', 4));
+        painter.drawText(QRect(area.left(), area.bottom() + 2, area.width(), kMarginBottom - 2), Qt::AlignRight,
+                         QString("red %1 V   C18").arg(hi, 0, 'f', 4));
+    }
+}
+
+void ChainHeatMap::mousePressEvent(QMouseEvent *event)
+{
+    const QRect area = mapRect();
+    const int afes = source ? source->afeCount() : 0;
+    const int y = static_cast<int>(event->pos().y());
+    if (afes > 0 && y >= area.top() && y <= area.bottom())
+        emit afeClicked(std::min((y - area.top()) * afes / std::max(area.height(), 1), afes - 1));
+    QWidget::mousePressEvent(event);
+}
@@ -0,0 +1,69 @@
+#ifndef PLOTVIEWS_H
+#define PLOTVIEWS_H
+
+#include <QWidget>
+
+#include <cstdint>
+#include <vector>
+
+#include "EmuCellHistory.h"
+#include "EmuRegisterDecoder.h"
+
+// Cell voltage time series of a range of AFEs (all 18 cells each).
+//
+// Every repaint decimates each channel into one min/max bucket per pixel
+// column of the plot (EmuCellHistory::decimate) and draws one vertical
+// segment per bucket, so the cost follows the widget width and the number
+// of traces, never the number of samples received.
+class TimeSeriesView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TimeSeriesView(QWidget *parent = nullptr);
+
+    void setSource(const EmuCellHistory *history);
+    void setAfes(int first, int count);     // 0-based
+    void setWindow(double seconds);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    const EmuCellHistory *source = nullptr;
+    int firstAfe = 0;
+    int afeCount = 1;
+    uint64_t windowNs = 10000000000ull;
+
+    // paintEvent() scratch: [trace][bucket]
+    std::vector<float> minV;
+    std::vector<float> maxV;
+};
+
+// Latest cell voltage of every AFE of the chain, one row per AFE and one
+// column per cell, colored from the lowest (blue) to the highest (red)
+// value received. Rendered through a (cells x AFEs) image scaled to the
+// widget, so a 1024 AFE chain costs the same as a short one to paint.
+class ChainHeatMap : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ChainHeatMap(QWidget *parent = nullptr);
+
+    void setSource(const EmuRegisterDecoder *decoder);
+
+signals:
+    void afeClicked(int afe);               // 0-based
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    QRect mapRect() const;
+
+    const EmuRegisterDecoder *source = nullptr;
+};
+
+#endif // PLOTVIEWS_H
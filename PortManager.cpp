@@ -0,0 +1,263 @@
+#include "PortManager.h"
+
+#include <QMetaObject>
+#include <QTimer>
+
+#include <algorithm>
+
+#define PORT_MANAGER_RX_BATCH           (256)   //records per port per popRx
+#define PORT_MANAGER_REOPEN_RETRY       (1000)  //ms, 節點已出現但還打不開 (權限尚未套用)
+#define PORT_MANAGER_REOPEN_TRIES       (5)
+
+PortManager::PortManager(QObject *parent)
+    : QObject(parent)
+    , scanThread(new QThread(this))
+    , scanner(new PortScanner())
+{
+    createPort(0);
+
+    // 列舉 COM 埠在背景執行緒，熱插拔時自動重新掃描
+    scanner->moveToThread(scanThread);
+    connect(scanThread, &QThread::finished, scanner, &QObject::deleteLater);
+    connect(scanner, &PortScanner::portsScanned, this, &PortManager::onPortsScanned);
+    scanThread->start();
+    QMetaObject::invokeMethod(scanner, &PortScanner::start, Qt::QueuedConnection);
+}
+
+PortManager::~PortManager()
+{
+    scanThread->quit();
+    scanThread->wait();
+    for (int id = kMaxPorts - 1; id >= 0; --id)
+        destroyPort(id);
+}
+
+int PortManager::createPort(int id)
+{
+    Port &p = ports[id];
+    p.thread = new QThread(this);
+    p.worker = new SerialWorker();
+    p.worker->moveToThread(p.thread);
+    connect(p.thread, &QThread::finished, p.worker, &QObject::deleteLater);
+    connect(p.worker, &SerialWorker::portOpened, this, [this, id](bool ok, const QString &message) {
+        Port &port = ports[id];
+        if (!port.reopening) {
+            emit portOpened(id, ok, message);
+            return;
+        }
+        port.reopening = false;
+        if (!ok) {
+            // 之後的掃描會再試；剛插上時多試幾次
+            port.lost = true;
+            if (++port.reopenTries < PORT_MANAGER_REOPEN_TRIES)
+                QTimer::singleShot(PORT_MANAGER_REOPEN_RETRY, this, &PortManager::scanPorts);
+        }
+        emit portReopened(id, ok, message);
+        emit portsChanged();
+    });
+    connect(p.worker, &SerialWorker::portLost, this, [this, id](const QString &message) {
+        ports[id].lost = true;
+        ports[id].reopenTries = 0;
+        emit portLost(id, message);
+        emit portsChanged();
+    });
+    p.thread->start();
+    return id;
+}
+
+void PortManager::destroyPort(int id)
+{
+    Port &p = ports[id];
+    if (!p.worker)
+        return;
+
+    closePort(id);
+    p.thread->quit();
+    p.thread->wait();
+    delete p.thread;
+    p = Port();     // 連同尚未交出的 RX
+}
+
+SerialWorker *PortManager::worker(int id) const
+{
+    return (id >= 0 && id < kMaxPorts) ? ports[id].worker : nullptr;
+}
+
+QList<int> PortManager::portIds() const
+{
+    QList<int> ids;
+    for (int id = 0; id < kMaxPorts; ++id)
+        if (ports[id].worker)
+            ids.append(id);
+    return ids;
+}
+
+QString PortManager::portName(int id) const
+{
+    return worker(id) ? ports[id].name : QString();
+}
+
+int PortManager::addPort(const QString &name, const SerialConfig &config)
+{
+    for (int id = 1; id < kMaxPorts; ++id) {
+        if (ports[id].worker)
+            continue;
+        createPort(id);
+        openPort(id, name, config);
+        emit portsChanged();
+        return id;
+    }
+    return -1;
+}
+
+void PortManager::openPort(int id, const QString &name, const SerialConfig &config)
+{
+    if (!worker(id))
+        return;
+    Port &p = ports[id];
+    p.name = name;
+    p.config = config;
+    p.device = SerialPortId();
+    p.device.name = name;
+    for (const SerialPortId &d : available)
+        if (d.name == name)
+            p.device = d;
+    p.lost = false;
+    p.reopening = false;
+    startOpen(id);
+}
+
+void PortManager::startOpen(int id)
+{
+    SerialWorker *w = ports[id].worker;
+    const QString name = ports[id].name;
+    const SerialConfig config = ports[id].config;
+    QMetaObject::invokeMethod(w, [w, name, config]() {
+        w->openPort(name, config);
+    }, Qt::QueuedConnection);
+}
+
+void PortManager::closePort(int id)
+{
+    SerialWorker *w = worker(id);
+    if (!w)
+        return;
+    // 手動關閉後就不再自動重新開啟
+    Port &p = ports[id];
+    p.lost = false;
+    p.reopening = false;
+    p.reopenTries = 0;
+    QMetaObject::invokeMethod(w, &SerialWorker::closePort, Qt::BlockingQueuedConnection);
+}
+
+void PortManager::scanPorts()
+{
+    QMetaObject::invokeMethod(scanner, &PortScanner::scan, Qt::QueuedConnection);
+}
+
+void PortManager::onPortsScanned(const QList<SerialPortId> &list)
+{
+    available = list;
+
+    // 拔除的埠: 同一個轉接器再出現 (名稱可能不同) 就用原設定重新開啟
+    for (int id = 0; id < kMaxPorts; ++id) {
+        Port &p = ports[id];
+        if (!p.worker || !p.lost || p.reopening)
+            continue;
+        for (const SerialPortId &d : list) {
+            if (!d.sameDevice(p.device))
+                continue;
+            p.lost = false;
+            p.reopening = true;
+            p.name = d.name;
+            p.device = d;
+            startOpen(id);
+            break;
+        }
+    }
+
+    emit portsScanned(list);
+}
+
+void PortManager::removePort(int id)
+{
+    if (id <= 0 || id >= kMaxPorts || !ports[id].worker)
+        return;
+    destroyPort(id);
+    emit portsChanged();
+}
+
+QVector<SerialWorker *> PortManager::openWorkers() const
+{
+    QVector<SerialWorker *> out;
+    for (const Port &p : ports)
+        if (p.worker && p.worker->isOpen())
+            out.append(p.worker);
+    return out;
+}
+
+bool PortManager::anyOpen() const
+{
+    for (const Port &p : ports)
+        if (p.worker && p.worker->isOpen())
+            return true;
+    return false;
+}
+
+int PortManager::post(int target, const uint8_t *frame, int size)
+{
+    int queued = 0;
+    for (int id = 0; id < kMaxPorts; ++id) {
+        SerialWorker *w = ports[id].worker;
+        if (!w || !w->isOpen() || (target != kAllPorts && target != id))
+            continue;
+        if (w->postTx(frame, size))
+            ++queued;
+    }
+    return queued;
+}
+
+size_t PortManager::popRx(MergedRxRecord *out, size_t maxCount)
+{
+    // 每個埠本身已依時間排序: 各埠讀一小段，每次輸出時間戳最小的開頭 (k-way merge)
+    bool idle[kMaxPorts] = {};      // queue found empty during this call
+    size_t n = 0;
+    while (n < maxCount) {
+        uint64_t limit = UINT64_MAX;
+        int best = -1;
+        for (int id = 0; id < kMaxPorts; ++id) {
+            Port &p = ports[id];
+            if (!p.worker)
+                continue;
+            if (p.rxHead == p.rxCount) {
+                if (idle[id])
+                    continue;
+                p.rx.resize(PORT_MANAGER_RX_BATCH);
+                p.rxCount = p.worker->popRx(p.rx.data(), PORT_MANAGER_RX_BATCH);
+                p.rxHead = 0;
+                if (p.rxCount == 0) {
+                    idle[id] = true;
+                    continue;
+                }
+            }
+            // 還有資料在佇列裡的埠，輸出不能超過它最後讀到的時間
+            if (p.worker->rxQueued() > 0)
+                limit = std::min(limit, p.rx[p.rxCount - 1].timestampNs);
+            if (best < 0 || p.rx[p.rxHead].timestampNs < ports[best].rx[ports[best].rxHead].timestampNs)
+                best = id;
+        }
+        if (best < 0 || ports[best].rx[ports[best].rxHead].timestampNs > limit)
+            break;
+        out[n].port = static_cast<uint8_t>(best);
+        out[n].rec = ports[best].rx[ports[best].rxHead++];
+        ++n;
+    }
+    return n;
+}
+
+void PortManager::setCapture(EmuCaptureWriter *writer)
+{
+    for (int id = 0; id < kMaxPorts; ++id)
+        if (ports[id].worker)
+            ports[id].worker->setCapture(writer ? writer->source(static_cast<uint8_t>(id)) : nullptr);
+}
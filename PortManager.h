@@ -0,0 +1,115 @@
+#ifndef PORTMANAGER_H
+#define PORTMANAGER_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+#include <vector>
+
+#include "EmuCaptureWriter.h"
+#include "PortScanner.h"
+#include "SerialWorker.h"
+
+// One RX record of the merged stream
+struct MergedRxRecord
+{
+    uint8_t port;
+    EmuRxRecord rec;
+};
+
+// Owns one SerialWorker per emulator board, each on its own QThread, so N
+// boards use N cores instead of sharing one event loop.
+//
+// Port 0 always exists and is the port the single-board UI works with;
+// more ports are added with addPort(). The owning (GUI) thread is the only
+// control lane producer and RX consumer of every port: post() targets one
+// port or broadcasts, popRx() merges the RX of all ports into one stream
+// ordered by the record timestamps (one monotonic clock for all workers):
+// a k-way merge over a small per-port read-ahead, never emitting a record
+// newer than the last one read from a port that still has RX queued.
+//
+// The serial port list comes from a PortScanner on its own thread. A port
+// whose device disappears (unplugged) is reopened with the same settings as
+// soon as a scan lists the same adapter again (VID/PID/serial number, see
+// SerialPortId::sameDevice), possibly under another name; the worker, its
+// lanes and the capture source stay the same, so the session just resumes.
+class PortManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kMaxPorts = 8;
+    static constexpr int kAllPorts = -1;
+
+    explicit PortManager(QObject *parent = nullptr);
+    ~PortManager() override;
+
+    SerialWorker *primary() const { return ports[0].worker; }
+    SerialWorker *worker(int id) const;
+    QList<int> portIds() const;
+    QString portName(int id) const;
+
+    // Creates a worker and opens it; returns the id, -1 when all are in use.
+    // The result arrives through portOpened().
+    int addPort(const QString &name, const SerialConfig &config);
+    void openPort(int id, const QString &name, const SerialConfig &config);
+    void closePort(int id);         // blocking; also stops waiting for an unplugged device
+    void removePort(int id);        // not port 0; closes it and stops its thread
+
+    // Asynchronous, the list arrives through portsScanned()
+    void scanPorts();
+    const QList<SerialPortId> &availablePorts() const { return available; }
+    bool waitingForDevice(int id) const { return worker(id) && ports[id].lost; }
+
+    // Open ports only
+    QVector<SerialWorker *> openWorkers() const;
+    bool anyOpen() const;
+
+    // Returns the number of ports the frame was queued on
+    int post(int target, const uint8_t *frame, int size);
+
+    size_t popRx(MergedRxRecord *out, size_t maxCount);
+
+    // Every port records into its own source of writer (nullptr to stop)
+    void setCapture(EmuCaptureWriter *writer);
+
+signals:
+    void portOpened(int id, bool ok, const QString &message);
+    void portsChanged();
+    void portsScanned(const QList<SerialPortId> &ports);
+    void portLost(int id, const QString &message);
+    void portReopened(int id, bool ok, const QString &message);     // instead of portOpened
+
+private slots:
+    void onPortsScanned(const QList<SerialPortId> &list);
+
+private:
+    struct Port
+    {
+        QThread *thread = nullptr;
+        SerialWorker *worker = nullptr;
+        QString name;
+        SerialConfig config;
+        SerialPortId device;        // as listed when opened, to find it again
+        bool lost = false;          // unplugged, waiting for the device
+        bool reopening = false;
+        int reopenTries = 0;
+        std::vector<EmuRxRecord> rx;    // popped from the worker, rx[rxHead..rxCount) not handed out
+        size_t rxHead = 0;
+        size_t rxCount = 0;
+    };
+
+    int createPort(int id);
+    void destroyPort(int id);
+    void startOpen(int id);
+
+    Port ports[kMaxPorts];
+    QThread *scanThread;
+    PortScanner *scanner;
+    QList<SerialPortId> available;
+};
+
+#endif // PORTMANAGER_H
@@ -0,0 +1,97 @@
+#include "PortScanner.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSerialPortInfo>
+
+#include "EmuPtyStandIn.h"
+
+#define PORT_SCANNER_DEBOUNCE           (300)   //ms, 插拔後 udev 建立節點的時間
+#define PORT_SCANNER_POLL_INTERVAL      (2000)  //ms, 無 inotify 的平台
+
+bool SerialPortId::sameDevice(const SerialPortId &other) const
+{
+    if (!hasIds || !other.hasIds)
+        return name == other.name;
+    if (vendorId != other.vendorId || productId != other.productId)
+        return false;
+    if (!serialNumber.isEmpty() || !other.serialNumber.isEmpty())
+        return serialNumber == other.serialNumber;
+    return true;
+}
+
+PortScanner::PortScanner(QObject *parent)
+    : QObject(parent)
+    , debounceTimer(new QTimer(this))
+    , pollTimer(new QTimer(this))
+{
+    qRegisterMetaType<SerialPortId>("SerialPortId");
+    qRegisterMetaType<QList<SerialPortId>>("QList<SerialPortId>");
+
+    debounceTimer->setSingleShot(true);
+    debounceTimer->setInterval(PORT_SCANNER_DEBOUNCE);
+    connect(debounceTimer, &QTimer::timeout, this, &PortScanner::scan);
+
+    pollTimer->setInterval(PORT_SCANNER_POLL_INTERVAL);
+    connect(pollTimer, &QTimer::timeout, this, &PortScanner::scan);
+}
+
+void PortScanner::start()
+{
+#ifdef Q_OS_LINUX
+    // ttyUSB* / ttyACM* 的建立與移除都會改變 /dev；by-id 只有 USB 裝置
+    watcher = new QFileSystemWatcher(this);
+    watcher->addPath("/dev");
+    if (QFileInfo::exists("/dev/serial/by-id"))
+        watcher->addPath("/dev/serial/by-id");
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, &PortScanner::onDeviceChanged);
+#else
+    pollTimer->start();
+#endif
+    scan();
+}
+
+void PortScanner::onDeviceChanged()
+{
+#ifdef Q_OS_LINUX
+    // by-id 在第一個 USB 轉 UART 插入時才出現
+    if (watcher && !watcher->directories().contains("/dev/serial/by-id") && QFileInfo::exists("/dev/serial/by-id"))
+        watcher->addPath("/dev/serial/by-id");
+#endif
+    debounceTimer->start();
+}
+
+void PortScanner::scan()
+{
+    QList<SerialPortId> out;
+    const auto infos = QSerialPortInfo::availablePorts();
+    for (const QSerialPortInfo &info : infos) {
+        SerialPortId id;
+        id.name = info.portName();
+        id.description = info.description();
+        id.serialNumber = info.serialNumber();
+        id.hasIds = info.hasVendorIdentifier() && info.hasProductIdentifier();
+        if (id.hasIds) {
+            id.vendorId = info.vendorIdentifier();
+            id.productId = info.productIdentifier();
+        }
+        out.append(id);
+    }
+
+#ifdef Q_OS_UNIX
+    // 軟體模擬板 (EmulatorStandIn) 的 pty 不會被列舉，依連結名稱加入
+    const QFileInfo linkPrefix(QString::fromLatin1(EmuPtyStandIn::kLinkPrefix));
+    const QDir linkDir = linkPrefix.absoluteDir();
+    const QStringList links = linkDir.entryList({linkPrefix.fileName() + "*"}, QDir::System | QDir::Files, QDir::Name);
+    for (const QString &link : links) {
+        if (QFileInfo::exists(linkDir.filePath(link))) {   // 連結目標仍存在
+            SerialPortId id;
+            id.name = linkDir.filePath(link);
+            id.description = "EmulatorStandIn";
+            out.append(id);
+        }
+    }
+#endif
+
+    emit portsScanned(out);
+}
@@ -0,0 +1,58 @@
+#ifndef PORTSCANNER_H
+#define PORTSCANNER_H
+
+#include <QFileSystemWatcher>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+// One serial port as listed by the scanner; the USB ids identify the same
+// adapter again after it is replugged under another name.
+struct SerialPortId
+{
+    QString name;               // portName(), or the pty link path of a stand-in
+    QString description;
+    QString serialNumber;
+    quint16 vendorId = 0;
+    quint16 productId = 0;
+    bool hasIds = false;        // USB device
+
+    // Same physical adapter: VID/PID and, when the adapter reports one, the
+    // serial number; ports without USB ids only match by name
+    bool sameDevice(const SerialPortId &other) const;
+};
+
+// Enumerates serial ports on its own QThread, so a slow
+// QSerialPortInfo::availablePorts() (many USB-UARTs) never blocks the GUI.
+//
+// After start() the port list is refreshed on hot-plug: on Linux /dev is
+// watched (inotify) and a change is rescanned after a short debounce,
+// elsewhere the list is polled. portsScanned() is emitted for every scan,
+// so scan() also serves the "Scan" button.
+class PortScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PortScanner(QObject *parent = nullptr);
+
+public slots:
+    void start();       // scanner thread: begins watching, then scans once
+    void scan();
+
+signals:
+    void portsScanned(const QList<SerialPortId> &ports);
+
+private slots:
+    void onDeviceChanged();
+
+private:
+    QFileSystemWatcher *watcher = nullptr;
+    QTimer *debounceTimer;
+    QTimer *pollTimer;
+};
+
+Q_DECLARE_METATYPE(SerialPortId)
+
+#endif // PORTSCANNER_H
@@ -0,0 +1,125 @@
+#include "ReadbackModel.h"
+
+#include <QBrush>
+#include <QColor>
+
+#include <cmath>
+
+#include "HexFormat.h"
+
+namespace {
+
+enum Column
+{
+    FirstCell = 0,
+    FirstAux = FirstCell + EmuRegisterDecoder::kCellChannels,
+    FirstCfg = FirstAux + EmuRegisterDecoder::kAuxChannels,
+    Updates = FirstCfg + EmuRegisterDecoder::kCfgGroups,
+    DpecErrors,
+    ColumnCount
+};
+
+} // namespace
+
+ReadbackModel::ReadbackModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void ReadbackModel::setDecoder(const EmuRegisterDecoder *d)
+{
+    beginResetModel();
+    decoder = d;
+    rows = decoder ? decoder->afeCount() : 0;
+    endResetModel();
+}
+
+void ReadbackModel::refresh()
+{
+    const int now = decoder ? decoder->afeCount() : 0;
+    if (now < rows) {
+        // decoder reset
+        beginResetModel();
+        rows = now;
+        endResetModel();
+        return;
+    }
+    if (now > rows) {
+        beginInsertRows(QModelIndex(), rows, now - 1);
+        rows = now;
+        endInsertRows();
+    }
+    if (rows > 0)
+        emit dataChanged(index(0, 0), index(rows - 1, ColumnCount - 1), {Qt::DisplayRole, Qt::ForegroundRole});
+}
+
+int ReadbackModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows;
+}
+
+int ReadbackModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ReadbackModel::data(const QModelIndex &index, int role) const
+{
+    if (!decoder || !index.isValid() || index.row() >= rows)
+        return QVariant();
+
+    const int afe = index.row();
+    const int col = index.column();
+
+    auto sum = [this, afe](uint32_t (EmuRegisterDecoder::*counter)(int, int) const) {
+        uint64_t total = 0;
+        for (int g = 0; g < EmuFrame::kRegGroupCount; ++g)
+            total += (decoder->*counter)(afe, g);
+        return total;
+    };
+
+    if (role == Qt::DisplayRole) {
+        double v = NAN;
+        if (col < FirstAux)
+            v = decoder->cellVolts(col - FirstCell)[afe];
+        else if (col < FirstCfg)
+            v = decoder->auxVolts(col - FirstAux)[afe];
+        else if (col < Updates) {
+            const int group = col - FirstCfg;
+            if (decoder->updates(afe, EmuFrame::kRegGroupCount - EmuRegisterDecoder::kCfgGroups + group) == 0)
+                return QVariant();
+            char hex[HexFormat::bufferSize(EmuFrame::kRegDataLen)];
+            const size_t len = HexFormat::format(decoder->config(afe, group), EmuFrame::kRegDataLen, hex);
+            return QString::fromLatin1(hex, static_cast<int>(len));
+        } else if (col == Updates) {
+            return QString::number(sum(&EmuRegisterDecoder::updates));
+        } else {
+            return QString::number(sum(&EmuRegisterDecoder::dpecErrors));
+        }
+        return std::isnan(v) ? QVariant() : QVariant(QString::number(v, 'f', 4));
+    }
+
+    if (role == Qt::ForegroundRole && col == DpecErrors && sum(&EmuRegisterDecoder::dpecErrors) > 0)
+        return QBrush(QColor(Qt::darkRed));
+
+    if (role == Qt::TextAlignmentRole)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+
+    return QVariant();
+}
+
+QVariant ReadbackModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Vertical)
+        return QString("AFE%1").arg(section + 1);
+
+    if (section < FirstAux)
+        return QString("C%1").arg(section - FirstCell + 1);
+    if (section < FirstCfg)
+        return QString("Aux%1").arg(section - FirstAux + 1);
+    if (section < Updates)
+        return section == FirstCfg ? QString("CFGA") : QString("CFGB");
+    return section == Updates ? QString("Updates") : QString("DPEC Err");
+}
@@ -0,0 +1,32 @@
+#ifndef READBACKMODEL_H
+#define READBACKMODEL_H
+
+#include <QAbstractTableModel>
+
+#include "EmuRegisterDecoder.h"
+
+// Table view of an EmuRegisterDecoder: one row per AFE, columns C1~C18 and
+// Aux1~Aux15 in V, CFGA/CFGB as hex, then update and DPEC error counts.
+// Cells are formatted only when a view asks for them; refresh() publishes
+// new rows / values (call it at display rate, not per frame).
+class ReadbackModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit ReadbackModel(QObject *parent = nullptr);
+
+    void setDecoder(const EmuRegisterDecoder *decoder);    // nullptr: empty table
+    void refresh();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    const EmuRegisterDecoder *decoder = nullptr;
+    int rows = 0;
+};
+
+#endif // READBACKMODEL_H
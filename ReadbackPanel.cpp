@@ -0,0 +1,100 @@
+#include "ReadbackPanel.h"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+#include "PortManager.h"
+
+#define APP_READBACK_REFRESH_INTERVAL   (250)   //ms
+
+ReadbackPanel::ReadbackPanel(QWidget *parent)
+    : QWidget(parent)
+    , decoders(PortManager::kMaxPorts)
+    , histories(PortManager::kMaxPorts)
+    , model(new ReadbackModel(this))
+    , spinPort(new QSpinBox(this))
+    , btnClear(new QPushButton("Clear", this))
+    , labelStats(new QLabel(this))
+    , view(new QTableView(this))
+    , refreshTimer(new QTimer(this))
+{
+    for (size_t i = 0; i < decoders.size(); ++i)
+        decoders[i].setHistory(&histories[i]);
+
+    spinPort->setRange(0, PortManager::kMaxPorts - 1);
+    spinPort->setPrefix("P");
+
+    view->setModel(model);
+    view->setSelectionBehavior(QAbstractItemView::SelectRows);
+    view->verticalHeader()->setDefaultSectionSize(20);
+    view->horizontalHeader()->setDefaultSectionSize(64);
+
+    QHBoxLayout *top = new QHBoxLayout();
+    top->addWidget(new QLabel("Port", this));
+    top->addWidget(spinPort);
+    top->addWidget(btnClear);
+    top->addWidget(labelStats, 1);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(top);
+    layout->addWidget(view);
+
+    connect(spinPort, QOverload<int>::of(&QSpinBox::valueChanged), this, &ReadbackPanel::onPortChanged);
+    connect(btnClear, &QPushButton::clicked, this, &ReadbackPanel::clear);
+
+    // 表格只在分頁可見時更新
+    refreshTimer->setInterval(APP_READBACK_REFRESH_INTERVAL);
+    connect(refreshTimer, &QTimer::timeout, this, &ReadbackPanel::onRefresh);
+    refreshTimer->start();
+
+    onPortChanged(0);
+}
+
+void ReadbackPanel::addRecord(uint8_t port, const EmuRxRecord &rec)
+{
+    if (port >= decoders.size())
+        return;
+    switch (rec.kind) {
+    case EmuRxRecord::Frame:
+    case EmuRxRecord::DpecError:    // DPEC is checked again per record
+        decoders[port].addFrame(rec.data, rec.size, rec.timestampNs);
+        break;
+    case EmuRxRecord::Burst:
+        decoders[port].addBurstData(rec.data, rec.size);
+        break;
+    default:
+        break;
+    }
+}
+
+void ReadbackPanel::flush()
+{
+    for (EmuRegisterDecoder &d : decoders)
+        d.flush();
+}
+
+void ReadbackPanel::clear()
+{
+    decoders[static_cast<size_t>(spinPort->value())].reset();
+    histories[static_cast<size_t>(spinPort->value())].reset();
+    model->refresh();
+    onRefresh();
+}
+
+void ReadbackPanel::onPortChanged(int port)
+{
+    model->setDecoder(&decoders[static_cast<size_t>(port)]);
+    onRefresh();
+}
+
+void ReadbackPanel::onRefresh()
+{
+    if (!isVisible())
+        return;
+    model->refresh();
+    const EmuRegisterDecoder::Stats &st = decoders[static_cast<size_t>(spinPort->value())].stats();
+    labelStats->setText(QString("AFEs %1, records %2, DPEC errors %3")
+                            .arg(decoders[static_cast<size_t>(spinPort->value())].afeCount())
+                            .arg(st.records).arg(st.dpecErrors));
+}
@@ -0,0 +1,52 @@
+#ifndef READBACKPANEL_H
+#define READBACKPANEL_H
+
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableView>
+#include <QTimer>
+#include <QWidget>
+
+#include <vector>
+
+#include "EmuRegisterDecoder.h"
+#include "ReadbackModel.h"
+#include "SerialWorker.h"
+
+// "Readback" tab: register values received from each board, decoded to
+// volts / raw config bytes. RX records are added as they are polled and
+// decoded per batch by flush(); the table follows the selected port.
+// Also keeps the cell history of every port for the "Plot" tab.
+class ReadbackPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ReadbackPanel(QWidget *parent = nullptr);
+
+    void addRecord(uint8_t port, const EmuRxRecord &rec);
+    void flush();      // end of one RX poll batch
+
+    const EmuRegisterDecoder &decoder(int port) const { return decoders[static_cast<size_t>(port)]; }
+    const EmuCellHistory &history(int port) const { return histories[static_cast<size_t>(port)]; }
+
+public slots:
+    void clear();
+
+private slots:
+    void onPortChanged(int port);
+    void onRefresh();
+
+private:
+    std::vector<EmuRegisterDecoder> decoders;  // per PortManager id
+    std::vector<EmuCellHistory> histories;     // fed by decoders[i]
+    ReadbackModel *model;
+    QSpinBox *spinPort;
+    QPushButton *btnClear;
+    QLabel *labelStats;
+    QTableView *view;
+    QTimer *refreshTimer;
+};
+
+#endif // READBACKPANEL_H
@@ -0,0 +1,110 @@
+#include "RxStreamDiff.h"
+
+#include <cstring>
+
+#include "HexFormat.h"
+
+bool RxStreamDiff::open(const QString &path, QString *error)
+{
+    close();
+    return reader.open(path, error);
+}
+
+void RxStreamDiff::close()
+{
+    reader.close();
+    cursor = 0;
+    st = Stats();
+    report.clear();
+}
+
+bool RxStreamDiff::isCompared(uint8_t kind)
+{
+    return kind == EmuCapture::Frame || kind == EmuCapture::DpecError || kind == EmuCapture::Burst;
+}
+
+bool RxStreamDiff::nextExpected(uint64_t from, uint64_t &index) const
+{
+    for (uint64_t i = from; i < reader.count(); ++i) {
+        const EmuCapture::Record &rec = reader.at(i);
+        if (rec.direction == EmuCapture::Rx && rec.portId == kPort && isCompared(rec.kind)) {
+            index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RxStreamDiff::equals(const EmuCapture::Record &rec, uint8_t kind, const uint8_t *data, int size) const
+{
+    return rec.kind == kind && rec.size == size && std::memcmp(rec.data, data, static_cast<size_t>(size)) == 0;
+}
+
+bool RxStreamDiff::feed(uint8_t kind, const uint8_t *data, int size)
+{
+    if (!reader.isOpen() || !isCompared(kind))
+        return true;
+
+    uint64_t expected = 0;
+    if (!nextExpected(cursor, expected)) {
+        ++st.extra;
+        addReport("extra", reader.count(), data, size);
+        return false;
+    }
+
+    if (equals(reader.at(expected), kind, data, size)) {
+        ++st.matched;
+        cursor = expected + 1;
+        return true;
+    }
+
+    // 往後找幾筆，找到就視為中間的封包遺失
+    uint64_t probe = expected;
+    for (int k = 1; k <= kLookahead; ++k) {
+        if (!nextExpected(probe + 1, probe))
+            break;
+        if (equals(reader.at(probe), kind, data, size)) {
+            for (uint64_t i = expected; i < probe; ++i) {
+                const EmuCapture::Record &rec = reader.at(i);
+                if (rec.direction == EmuCapture::Rx && rec.portId == kPort && isCompared(rec.kind)) {
+                    ++st.missing;
+                    addReport("missing", i, rec.data, rec.size);
+                }
+            }
+            ++st.matched;
+            cursor = probe + 1;
+            return false;
+        }
+    }
+
+    ++st.mismatched;
+    addReport("mismatch", expected, data, size);
+    cursor = expected + 1;
+    return false;
+}
+
+void RxStreamDiff::finish()
+{
+    uint64_t expected = 0;
+    while (nextExpected(cursor, expected)) {
+        const EmuCapture::Record &rec = reader.at(expected);
+        ++st.missing;
+        addReport("missing", expected, rec.data, rec.size);
+        cursor = expected + 1;
+    }
+}
+
+void RxStreamDiff::addReport(const char *what, uint64_t index, const uint8_t *data, int size)
+{
+    if (report.size() >= kMaxReported)
+        return;
+    char hexStr[HexFormat::bufferSize(APP_EMU_UART_PACKET_LEN)];
+    const size_t len = HexFormat::format(data, static_cast<size_t>(size), hexStr);
+    report.append(QString("%1 @%2: %3").arg(what).arg(index).arg(QString::fromLatin1(hexStr, static_cast<int>(len))));
+}
+
+QString RxStreamDiff::summary() const
+{
+    return QString("RX diff: matched %1, mismatched %2, missing %3, extra %4")
+        .arg(st.matched).arg(st.mismatched).arg(st.missing).arg(st.extra);
+}
@@ -0,0 +1,62 @@
+#ifndef RXSTREAMDIFF_H
+#define RXSTREAMDIFF_H
+
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+
+#include "EmuCaptureReader.h"
+
+// Compares live RX frames with the RX frames of a capture as they arrive.
+// Only the recorded RX of port kPort (the port CaptureReplayer replays) is
+// compared; feed it the live RX of that port only.
+//
+// Only decoded frames (Frame / DpecError) are compared; unframed bytes are
+// ignored on both sides. A live frame that matches one of the next
+// kLookahead recorded frames resynchronizes the cursor and counts the
+// frames skipped over as missing; otherwise it is counted as a mismatch
+// against the current recorded frame.
+class RxStreamDiff
+{
+public:
+    static constexpr int kLookahead = 32;
+    static constexpr int kMaxReported = 100;
+    static constexpr uint8_t kPort = 0;
+
+    struct Stats
+    {
+        quint64 matched = 0;
+        quint64 mismatched = 0;
+        quint64 missing = 0;        // recorded but never received
+        quint64 extra = 0;          // received after the recording ended
+    };
+
+    bool open(const QString &path, QString *error = nullptr);
+    void close();
+    bool isOpen() const { return reader.isOpen(); }
+
+    // Returns false when the frame differs from the recording
+    bool feed(uint8_t kind, const uint8_t *data, int size);
+
+    // Counts recorded frames never received as missing
+    void finish();
+
+    const Stats &stats() const { return st; }
+    bool identical() const { return st.mismatched == 0 && st.missing == 0 && st.extra == 0; }
+    const QStringList &differences() const { return report; }   // first kMaxReported
+    QString summary() const;
+
+private:
+    static bool isCompared(uint8_t kind);
+    bool nextExpected(uint64_t from, uint64_t &index) const;
+    bool equals(const EmuCapture::Record &rec, uint8_t kind, const uint8_t *data, int size) const;
+    void addReport(const char *what, uint64_t index, const uint8_t *data, int size);
+
+    EmuCaptureReader reader;
+    uint64_t cursor = 0;        // next recorded record to compare against
+    Stats st;
+    QStringList report;
+};
+
+#endif // RXSTREAMDIFF_H
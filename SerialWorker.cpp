@@ -0,0 +1,489 @@
+#include "SerialWorker.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMetaObject>
+
+#include <algorithm>
+#include <cstring>
+
+#include "EmuFrame.h"
+
+#define SERIAL_WORKER_TX_QUEUE_LEN      (4096)
+#define SERIAL_WORKER_RX_QUEUE_LEN      (16384)
+#define SERIAL_WORKER_BULK_QUEUE_LEN    (16384)
+#define SERIAL_WORKER_BULK_HIGH_WATER   (4096)  //bytes pending in QSerialPort
+#define SERIAL_WORKER_BULK_LOW_WATER    (1024)  //bytes, bulk refill resumes below
+#define SERIAL_WORKER_CTRL_HIGH_WATER   (6144)  //bytes, bulk high water + one TX batch
+#define SERIAL_WORKER_CTRL_LOW_WATER    (2048)  //bytes, held control frames resume below
+#define SERIAL_WORKER_TX_BATCH          (128)   //records coalesced per write()
+#define SERIAL_WORKER_RX_GAP_CHARS      (64)    //idle char times that end a partial frame
+#define SERIAL_WORKER_RX_GAP_MIN        (1)     //ms, QTimer resolution
+#define SERIAL_WORKER_CLOSE_DRAIN_MS    (1000)  //max wait for pending TX on close
+#define SERIAL_WORKER_PROBE_FRAMES      (256)   //test frames per probe step
+#define SERIAL_WORKER_PROBE_MIN_WAIT    (200)   //ms
+
+static_assert(SERIAL_WORKER_CTRL_HIGH_WATER > SERIAL_WORKER_BULK_HIGH_WATER,
+              "control frames still go out while bulk is held");
+
+static_assert(int(EmuRxRecord::Frame) == int(EmuCapture::Frame) &&
+              int(EmuRxRecord::DpecError) == int(EmuCapture::DpecError) &&
+              int(EmuRxRecord::Garbage) == int(EmuCapture::Garbage) &&
+              int(EmuRxRecord::Remain) == int(EmuCapture::Remain) &&
+              int(EmuRxRecord::Burst) == int(EmuCapture::Burst),
+              "RX kinds are stored as-is in captures");
+
+SerialWorker::SerialWorker(QObject *parent)
+    : QObject(parent)
+    , serial(new QSerialPort(this))
+    , rxGapTimer(new QTimer(this))
+    , txQueue(SERIAL_WORKER_TX_QUEUE_LEN)
+    , bulkQueue(SERIAL_WORKER_BULK_QUEUE_LEN)
+    , rxQueue(SERIAL_WORKER_RX_QUEUE_LEN)
+{
+    rxGapTimer->setSingleShot(true);
+    rxGapTimer->setTimerType(Qt::PreciseTimer);
+
+    connect(serial, &QSerialPort::readyRead, this, &SerialWorker::onReadyRead);
+    connect(serial, &QSerialPort::errorOccurred, this, &SerialWorker::onError);
+    connect(serial, &QSerialPort::bytesWritten, this, &SerialWorker::flushBulk);
+    connect(rxGapTimer, &QTimer::timeout, this, &SerialWorker::onRemainTimeout);
+}
+
+SerialWorker::~SerialWorker()
+{
+    if (serial->isOpen())
+        serial->close();
+}
+
+static void applyConfig(QSerialPort *port, const QString &portName, const SerialConfig &config)
+{
+    port->setPortName(portName);
+    port->setBaudRate(config.baudRate);
+    port->setDataBits(config.dataBits);
+    port->setParity(config.parity);
+    port->setStopBits(config.stopBits);
+    port->setFlowControl(config.flowControl);
+}
+
+int SerialWorker::rxGapFor(const SerialConfig &config)
+{
+    // 64 個字元時間約等於一個 USB full-speed 封包，USB 轉 UART 分段送達時
+    // 不會把同一個封包切開；115200 約 6 ms，1 Mbaud 以上為 1 ms
+    const qint64 us = static_cast<qint64>(SERIAL_WORKER_RX_GAP_CHARS) * config.bitsPerChar() * 1000000 /
+                      std::max<qint32>(config.baudRate, 1);
+    return static_cast<int>(std::min<qint64>(std::max<qint64>((us + 999) / 1000, SERIAL_WORKER_RX_GAP_MIN),
+                                             APP_EMU_REMAIN_DATA_DELAY));
+}
+
+void SerialWorker::openPort(const QString &portName, const SerialConfig &config)
+{
+    if (serial->isOpen())
+        closePort();
+
+    applyConfig(serial, portName, config);
+
+    rxDecoder.reset();
+    stats.reset();
+    partialLane = -1;
+    bulkHeld = false;
+    ctrlHeld = false;
+    if (!serial->open(QIODevice::ReadWrite)) {
+        emit portOpened(false, serial->errorString());
+        return;
+    }
+    linkRate.store(static_cast<uint32_t>(config.baudRate / config.bitsPerChar()), std::memory_order_relaxed);
+    rxGapMs = rxGapFor(config);
+    portOpen.store(true, std::memory_order_release);
+    emit portOpened(true, portName);
+}
+
+void SerialWorker::closePort()
+{
+    rxGapTimer->stop();
+    if (serial->isOpen()) {
+        // 關閉前送完已排入的封包
+        flushTx();
+        QElapsedTimer drain;
+        drain.start();
+        while (serial->bytesToWrite() > 0 && drain.elapsed() < SERIAL_WORKER_CLOSE_DRAIN_MS) {
+            if (!serial->waitForBytesWritten(SERIAL_WORKER_CLOSE_DRAIN_MS))
+                break;
+            flushTx();     // 水位以上還留在佇列的部分
+        }
+        serial->close();
+    }
+    partialLane = -1;
+    bulkHeld = false;
+    ctrlHeld = false;
+    linkRate.store(0, std::memory_order_relaxed);
+    portOpen.store(false, std::memory_order_release);
+    emit portClosed();
+}
+
+void SerialWorker::onError(QSerialPort::SerialPortError error)
+{
+    // 拔除 USB 轉 UART: 不等待 TX，直接關閉並丟掉排隊中的封包
+    if (error != QSerialPort::ResourceError || !serial->isOpen())
+        return;
+    const QString message = serial->errorString();
+    rxGapTimer->stop();
+    serial->close();
+    flushTx();
+    partialLane = -1;
+    bulkHeld = false;
+    ctrlHeld = false;
+    linkRate.store(0, std::memory_order_relaxed);
+    portOpen.store(false, std::memory_order_release);
+    emit portLost(message);
+    emit portClosed();
+}
+
+bool SerialWorker::postTx(const uint8_t *frame, int size, TxLane lane)
+{
+    SpscQueue<EmuTxRecord> &q = (lane == BulkLane) ? bulkQueue : txQueue;
+    size = std::min<int>(size, APP_EMU_BURST_FRAME_MAX);
+    const int records = (size + APP_EMU_UART_PACKET_LEN - 1) / APP_EMU_UART_PACKET_LEN;
+    // 單一 producer，可用空間只會變多，檢查後一定放得下
+    if (records > 1 && txFree(lane) < static_cast<size_t>(records))
+        return false;
+
+    EmuTxRecord rec;
+    rec.queuedNs = LatencyTracker::nowNs();
+    for (int offset = 0; offset < size; offset += APP_EMU_UART_PACKET_LEN) {
+        rec.size = static_cast<uint8_t>(std::min<int>(size - offset, APP_EMU_UART_PACKET_LEN));
+        rec.more = offset + rec.size < size;
+        std::memcpy(rec.data, frame + offset, rec.size);
+        if (!q.push(rec))
+            return false;
+    }
+
+    wakeTx();
+    return true;
+}
+
+void SerialWorker::wakeTx()
+{
+    // 只排一次 flushTx，避免每個封包都產生一個 event
+    if (!txWakePending.exchange(true, std::memory_order_acq_rel))
+        QMetaObject::invokeMethod(this, &SerialWorker::flushTx, Qt::QueuedConnection);
+}
+
+void SerialWorker::flushTx()
+{
+    // exchange (不是 store): 清旗標必須在讀佇列之前完成，否則 postTx 可能
+    // 看到舊的 true 而不再喚醒，封包留在佇列裡
+    txWakePending.exchange(false, std::memory_order_acq_rel);
+
+    // 先把寫到一半的 bulk burst 送完，flushBulk 結束時會再叫醒這裡
+    if (partialLane == BulkLane) {
+        flushBulk();
+        if (partialLane == BulkLane)
+            return;
+    }
+
+    EmuTxRecord batch[SERIAL_WORKER_TX_BATCH];
+    size_t n;
+    for (;;) {
+        // 控制封包也有上限，超過就留在佇列裡等 bytesWritten 降到低水位
+        size_t room = SERIAL_WORKER_TX_BATCH;
+        if (serial->isOpen()) {
+            const qint64 pending = serial->bytesToWrite();
+            if (pending >= SERIAL_WORKER_CTRL_HIGH_WATER)
+                ctrlHeld = true;
+            if (ctrlHeld && pending > SERIAL_WORKER_CTRL_LOW_WATER) {
+                updateTxQueued();
+                return;
+            }
+            ctrlHeld = false;
+            room = std::min<size_t>(room, static_cast<size_t>(SERIAL_WORKER_CTRL_HIGH_WATER - pending) / APP_EMU_UART_PACKET_LEN);
+            if (room == 0) {
+                ctrlHeld = true;
+                updateTxQueued();
+                return;
+            }
+        }
+        if ((n = txQueue.pop(batch, room)) == 0)
+            break;
+        if (!serial->isOpen())
+            continue;    // discard
+        writeFrames(batch, n, ControlLane);
+    }
+
+    // Producer still queueing the rest of a burst: its postTx wakes us again
+    if (partialLane == ControlLane) {
+        updateTxQueued();
+        return;
+    }
+    flushBulk();
+}
+
+void SerialWorker::writeFrames(const EmuTxRecord *batch, size_t n, TxLane lane)
+{
+    EmuCaptureWriter::Source *cap = capture.load(std::memory_order_acquire);
+    const EmuCapture::Kind kind = (lane == BulkLane) ? EmuCapture::Bulk : EmuCapture::Frame;
+    const uint64_t now = LatencyTracker::nowNs();
+    char stage[SERIAL_WORKER_TX_BATCH * APP_EMU_UART_PACKET_LEN];
+    size_t bytes = 0;
+    uint64_t frames = 0;
+    uint64_t queuedNs = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const bool continuation = (partialLane == lane);
+        std::memcpy(stage + bytes, batch[i].data, batch[i].size);
+        bytes += batch[i].size;
+        if (!continuation) {
+            ++frames;
+            queuedNs += now - std::min(now, batch[i].queuedNs);
+            if (batch[i].size == APP_EMU_UART_PACKET_LEN)
+                latency.onTx(batch[i].data, now);
+        }
+        if (cap)
+            cap->record(EmuCapture::Tx, continuation ? EmuCapture::Burst : kind, batch[i].data, batch[i].size);
+        partialLane = batch[i].more ? lane : -1;
+    }
+    // 整批合併成一次 write
+    serial->write(stage, static_cast<qint64>(bytes));
+
+    LinkStats::add(stats.txBytes, bytes);
+    LinkStats::add(stats.txFrames, frames);
+    LinkStats::add(stats.txQueueNs, queuedNs);
+    LinkStats::set(stats.txBacklog, static_cast<uint64_t>(serial->bytesToWrite()));
+}
+
+void SerialWorker::updateTxQueued()
+{
+    LinkStats::set(stats.txQueued, static_cast<uint64_t>(txQueue.size() + bulkQueue.size()));
+}
+
+size_t SerialWorker::txFree(TxLane lane) const
+{
+    const SpscQueue<EmuTxRecord> &q = (lane == BulkLane) ? bulkQueue : txQueue;
+    return q.capacity() - std::min(q.size(), q.capacity());
+}
+
+void SerialWorker::flushBulk()
+{
+    // 控制 burst 寫到一半被水位擋下: 剩下的部分已在佇列裡，由這裡叫醒
+    if (partialLane == ControlLane) {
+        if (txQueue.size() > 0)
+            wakeTx();
+        return;
+    }
+
+    EmuTxRecord batch[SERIAL_WORKER_TX_BATCH];
+    for (;;) {
+        size_t room = SERIAL_WORKER_TX_BATCH;
+        if (serial->isOpen()) {
+            const qint64 pending = serial->bytesToWrite();
+            LinkStats::set(stats.txBacklog, static_cast<uint64_t>(pending));
+            if (pending >= SERIAL_WORKER_BULK_HIGH_WATER)
+                bulkHeld = true;
+            if (bulkHeld && pending > SERIAL_WORKER_BULK_LOW_WATER)
+                break;     // 等 bytesWritten 降到低水位再一次補滿
+            bulkHeld = false;
+            room = std::min<size_t>(room, static_cast<size_t>(SERIAL_WORKER_BULK_HIGH_WATER - pending) / APP_EMU_UART_PACKET_LEN);
+            if (room == 0)
+                break;
+        }
+
+        const size_t n = bulkQueue.pop(batch, room);
+        if (n == 0)
+            break;
+        if (!serial->isOpen())
+            continue;    // discard
+        writeFrames(batch, n, BulkLane);
+    }
+
+    updateTxQueued();
+
+    // Control frames held back behind a burst / the control watermark
+    if (partialLane != BulkLane && txQueue.size() > 0)
+        wakeTx();
+}
+
+void SerialWorker::onReadyRead()
+{
+    const size_t before = rxDecoder.pending();
+    size_t received = 0;
+
+    // 直接讀入 ring buffer，不另外配置記憶體
+    for (;;) {
+        size_t room = 0;
+        uint8_t *dst = rxDecoder.writeBuffer(room);
+        if (room == 0) {
+            processRxFrames();
+            dst = rxDecoder.writeBuffer(room);
+            if (room == 0)
+                break;
+        }
+        qint64 n = serial->read(reinterpret_cast<char *>(dst), static_cast<qint64>(room));
+        if (n <= 0)
+            break;
+        rxDecoder.commit(static_cast<size_t>(n));
+        received += static_cast<size_t>(n);
+        LinkStats::add(stats.rxBytes, static_cast<uint64_t>(n));
+    }
+    processRxFrames();
+
+    const size_t pending = rxDecoder.pending();
+    if (pending == 0) {
+        rxGapTimer->stop();
+        return;
+    }
+
+    // 殘留的不完整封包: 線路靜止 rxGapMs 就送出，但最多保留
+    // APP_EMU_REMAIN_DATA_DELAY，持續有零星資料也不會一直延後
+    const uint64_t now = LatencyTracker::nowNs();
+    if (!rxGapTimer->isActive() || before + received > pending)
+        rxHoldSinceNs = now;       // decoder consumed bytes: a new partial frame
+    // 已確認的 burst header 正在等 payload 時，再加上 payload 的傳輸時間
+    const uint64_t limitNs = rxDecoder.holdLimitNs(static_cast<uint64_t>(APP_EMU_REMAIN_DATA_DELAY) * 1000000u,
+                                                   linkRate.load(std::memory_order_relaxed));
+    const uint64_t heldNs = now - rxHoldSinceNs;
+    const qint64 leftMs = static_cast<qint64>((limitNs - std::min(limitNs, heldNs) + 999999u) / 1000000u);
+    rxHoldCapped = leftMs < rxGapMs;
+    rxGapTimer->start(static_cast<int>(std::min<qint64>(rxGapMs, leftMs)));
+}
+
+void SerialWorker::onRemainTimeout()
+{
+    // 可能是 burst 的前段，超過 16 bytes 就分成多筆
+    uint8_t remain[APP_EMU_UART_PACKET_LEN];
+    const uint64_t now = LatencyTracker::nowNs();
+    uint64_t bytes = 0;
+    size_t n;
+    while ((n = rxDecoder.drain(remain, sizeof(remain))) > 0) {
+        pushRx(EmuRxRecord::Remain, remain, static_cast<int>(n), now);
+        bytes += n;
+    }
+    if (bytes > 0) {
+        LinkStats::add(stats.partialFlushes, 1);
+        LinkStats::add(stats.partialBytes, bytes);
+        if (rxHoldCapped)
+            LinkStats::add(stats.holdExpired, 1);
+    }
+}
+
+void SerialWorker::processRxFrames()
+{
+    const uint64_t now = LatencyTracker::nowNs();
+    EmuFrameDecoder::Item item;
+    while (rxDecoder.next(item)) {
+        if (item.kind == EmuFrameDecoder::Item::Garbage) {
+            for (int i = 0; i < item.size; i += APP_EMU_UART_PACKET_LEN)
+                pushRx(EmuRxRecord::Garbage, item.data + i, std::min(APP_EMU_UART_PACKET_LEN, item.size - i), now);
+            continue;
+        }
+        latency.onRx(item.data, now);
+        pushRx((item.hasDpec && !item.dpecOk) ? EmuRxRecord::DpecError : EmuRxRecord::Frame,
+               item.data, APP_EMU_UART_PACKET_LEN, now);
+        // Burst payload (loopback plug, echoing firmware) in 16 bytes pieces
+        for (int i = APP_EMU_UART_PACKET_LEN; i < item.size; i += APP_EMU_UART_PACKET_LEN)
+            pushRx(EmuRxRecord::Burst, item.data + i, std::min(APP_EMU_UART_PACKET_LEN, item.size - i), now);
+    }
+
+    // 解碼器的計數只在 I/O 執行緒更新，這裡同步到 atomic 計數器
+    const EmuFrameDecoder::Stats &d = rxDecoder.stats();
+    LinkStats::set(stats.rxFrames, d.frames);
+    LinkStats::set(stats.checksumErrors, d.checksumErrors);
+    LinkStats::set(stats.dpecErrors, d.dpecErrors);
+    LinkStats::set(stats.resyncs, d.resyncs);
+    LinkStats::set(stats.garbageBytes, d.garbageBytes);
+}
+
+void SerialWorker::pushRx(EmuRxRecord::Kind kind, const uint8_t *data, int size, uint64_t timestampNs)
+{
+    EmuRxRecord rec;
+    rec.timestampNs = timestampNs;
+    rec.kind = kind;
+    rec.size = static_cast<uint8_t>(size);
+    std::memcpy(rec.data, data, static_cast<size_t>(size));
+
+    if (EmuCaptureWriter::Source *cap = capture.load(std::memory_order_acquire))
+        cap->record(EmuCapture::Rx, static_cast<EmuCapture::Kind>(kind), data, size);
+
+    if (!rxQueue.push(rec))
+        LinkStats::add(stats.rxOverflows, 1);
+}
+
+QList<qint32> SerialWorker::defaultProbeRates()
+{
+    return {115200, 230400, 460800, 921600, 1000000, 1500000, 2000000, 3000000, 4000000};
+}
+
+void SerialWorker::probeBaudRates(const QString &portName, const SerialConfig &config, const QList<qint32> &rates)
+{
+    if (serial->isOpen())
+        closePort();
+
+    qint32 best = 0;
+    for (qint32 rate : rates) {
+        SerialConfig step = config;
+        step.baudRate = rate;
+        QString detail;
+        const bool ok = probeRate(portName, step, detail);
+        if (ok)
+            best = std::max(best, rate);
+        emit probeStep(rate, ok, detail);
+    }
+    emit probeFinished(best);
+}
+
+bool SerialWorker::probeRate(const QString &portName, const SerialConfig &config, QString &detail)
+{
+    QSerialPort port;
+    applyConfig(&port, portName, config);
+    if (!port.open(QIODevice::ReadWrite)) {
+        detail = port.errorString();
+        return false;
+    }
+    if (port.baudRate() != config.baudRate) {
+        detail = QString("driver set %1 baud").arg(port.baudRate());
+        return false;
+    }
+    port.clear();
+
+    // 每個測試封包都帶不同的 AFE index / 資料，錯位或掉資料都會被發現
+    QByteArray sent;
+    sent.reserve(SERIAL_WORKER_PROBE_FRAMES * APP_EMU_UART_PACKET_LEN);
+    uint32_t lfsr = 0xACE1u;
+    for (int i = 0; i < SERIAL_WORKER_PROBE_FRAMES; ++i) {
+        uint8_t data[EmuFrame::kRegDataLen];
+        for (uint8_t &b : data) {
+            lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+            b = static_cast<uint8_t>(lfsr);
+        }
+        const EmuFrame::Frame f = EmuFrame::encodeRegGroup<SPI_CMD_RDCVA>(static_cast<uint8_t>(i), data);
+        sent.append(reinterpret_cast<const char *>(f.data()), static_cast<int>(f.size()));
+    }
+
+    const qint64 wireMs = static_cast<qint64>(sent.size()) * config.bitsPerChar() * 1000 / config.baudRate;
+    const qint64 timeoutMs = std::max<qint64>(SERIAL_WORKER_PROBE_MIN_WAIT, 3 * wireMs);
+
+    QElapsedTimer clock;
+    clock.start();
+    port.write(sent);
+
+    QByteArray received;
+    while (received.size() < sent.size() && clock.elapsed() < timeoutMs) {
+        if (port.bytesToWrite() > 0)
+            port.waitForBytesWritten(10);
+        if (port.waitForReadyRead(10))
+            received.append(port.readAll());
+    }
+    port.close();
+
+    if (received.size() < sent.size()) {
+        detail = QString("received %1/%2 bytes").arg(received.size()).arg(sent.size());
+        return false;
+    }
+    if (received.left(sent.size()) != sent) {
+        int i = 0;
+        while (received.at(i) == sent.at(i))
+            ++i;
+        detail = QString("mismatch at byte %1").arg(i);
+        return false;
+    }
+    detail = QString("%1 bytes echoed in %2 ms").arg(sent.size()).arg(clock.elapsed());
+    return true;
+}
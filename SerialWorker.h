@@ -0,0 +1,177 @@
+#ifndef SERIALWORKER_H
+#define SERIALWORKER_H
+
+#include <QList>
+#include <QObject>
+#include <QSerialPort>
+#include <QString>
+#include <QTimer>
+
+#include <atomic>
+#include <cstdint>
+
+#include "EmuCaptureWriter.h"
+#include "EmuFrameDecoder.h"
+#include "EmuProtocol.h"
+#include "LatencyTracker.h"
+#include "LinkStats.h"
+#include "SpscQueue.h"
+
+// One record per received frame / run of unframed bytes
+struct EmuRxRecord
+{
+    // Burst: 16 bytes piece of a 0x8030 payload, after its header (Frame /
+    // DpecError). Same value as EmuCapture::Burst, 4 is the TX only Bulk.
+    enum Kind : uint8_t { Frame, DpecError, Garbage, Remain, Burst = 5 };
+
+    uint64_t timestampNs;       // LatencyTracker::nowNs(), same clock for every port
+    uint8_t kind;
+    uint8_t size;
+    uint8_t data[APP_EMU_UART_PACKET_LEN];
+};
+
+// Frames longer than 16 bytes (bursts) take several records of one lane,
+// all but the last with more set
+struct EmuTxRecord
+{
+    uint64_t queuedNs;          // LatencyTracker::nowNs() at postTx, for time-in-queue
+    uint8_t size;
+    bool more;
+    uint8_t data[APP_EMU_UART_PACKET_LEN];
+};
+
+// Line settings; any baud rate the driver accepts (multi-Mbaud USB-UARTs)
+struct SerialConfig
+{
+    qint32 baudRate = QSerialPort::Baud115200;
+    QSerialPort::DataBits dataBits = QSerialPort::Data8;
+    QSerialPort::Parity parity = QSerialPort::NoParity;
+    QSerialPort::StopBits stopBits = QSerialPort::OneStop;
+    QSerialPort::FlowControl flowControl = QSerialPort::NoFlowControl;
+
+    // Start + data + parity + stop bits on the wire per byte
+    int bitsPerChar() const
+    {
+        return 1 + static_cast<int>(dataBits) + (parity == QSerialPort::NoParity ? 0 : 1) +
+               (stopBits == QSerialPort::OneStop ? 1 : 2);
+    }
+};
+
+// Owns the QSerialPort and runs on its own QThread.
+//
+// The GUI thread only talks to it through SPSC queues (postTx / popRx) and
+// queued slot calls for open/close, so a busy repaint or a modal dialog no
+// longer stalls reception.
+//
+// TX has two lanes, each with its own single producer: Control (GUI clicks)
+// is written out as soon as possible, Bulk (stimulus streaming) is only fed
+// to the port while less than SERIAL_WORKER_BULK_HIGH_WATER bytes are
+// pending, and refilled from bytesWritten once that drops under
+// SERIAL_WORKER_BULK_LOW_WATER, so the link stays saturated without burying
+// control frames behind seconds of queued data. Control has its own pair,
+// SERIAL_WORKER_CTRL_HIGH_WATER (above the bulk one, so control still goes
+// out while bulk is held) and SERIAL_WORKER_CTRL_LOW_WATER; either way the
+// frames wait in the bounded lane and postTx() fails when it is full,
+// instead of growing QSerialPort's buffer.
+// Frames popped together are coalesced into a single write().
+class SerialWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SerialWorker(QObject *parent = nullptr);
+    ~SerialWorker() override;
+
+    enum TxLane { ControlLane, BulkLane };
+
+    // Any (single, per lane) producer thread. A burst frame is queued whole
+    // or not at all, and no frame of the other lane is written in between.
+    bool postTx(const uint8_t *frame, int size, TxLane lane = ControlLane);
+    size_t txFree(TxLane lane) const;
+
+    // Raw link capacity of the open port (baud / bits per char), 0 when closed
+    uint32_t linkBytesPerSec() const { return linkRate.load(std::memory_order_relaxed); }
+
+    // Any (single) consumer thread
+    size_t popRx(EmuRxRecord *out, size_t maxCount) { return rxQueue.pop(out, maxCount); }
+    size_t rxQueued() const { return rxQueue.size(); }
+
+    bool isOpen() const { return portOpen.load(std::memory_order_acquire); }
+    uint64_t rxOverflows() const { return stats.rxOverflows.load(std::memory_order_relaxed); }
+
+    // Counters of the current port session, readable from any thread
+    const LinkStats &linkStats() const { return stats; }
+
+    // Record every frame written to / decoded from the port, nullptr to stop
+    void setCapture(EmuCaptureWriter::Source *source) { capture.store(source, std::memory_order_release); }
+
+    // TX -> RX latency per command. I/O thread only: call through
+    // QMetaObject::invokeMethod(..., Qt::BlockingQueuedConnection). The
+    // snapshot counts requests older than kTimeoutNs as unanswered.
+    std::vector<LatencyTracker::CommandStats> latencySnapshot() { return latency.snapshot(LatencyTracker::nowNs()); }
+    void resetLatency() { latency.reset(); }
+
+    // Default probe steps, 115200 up to 4 Mbaud
+    static QList<qint32> defaultProbeRates();
+
+    // Line idle time (ms) after which a partial RX frame is flushed as
+    // Remain: SERIAL_WORKER_RX_GAP_CHARS character times at the configured
+    // rate, 1 ms minimum. A frame still partial APP_EMU_REMAIN_DATA_DELAY
+    // after its first byte is flushed even if bytes keep trickling in; a
+    // checked burst header extends that by the wire time of its payload
+    // (EmuFrameDecoder::holdLimitNs).
+    static int rxGapFor(const SerialConfig &config);
+
+public slots:
+    void openPort(const QString &portName, const SerialConfig &config);
+    void closePort();
+
+    // Closes the port, then for each rate (ascending) sends a burst of test
+    // frames and expects the same bytes back (loopback plug or echo
+    // firmware). Blocks the I/O thread while it runs.
+    void probeBaudRates(const QString &portName, const SerialConfig &config, const QList<qint32> &rates);
+
+signals:
+    void portOpened(bool ok, const QString &message);
+    void portClosed();
+    void portLost(const QString &message);       // device gone (unplugged), port closed
+    void probeStep(qint32 baudRate, bool ok, const QString &detail);
+    void probeFinished(qint32 bestBaudRate);     // 0 when no rate passed
+
+private slots:
+    void onReadyRead();
+    void onRemainTimeout();
+    void onError(QSerialPort::SerialPortError error);
+    void flushTx();
+
+private:
+    void flushBulk();
+    void processRxFrames();
+    void pushRx(EmuRxRecord::Kind kind, const uint8_t *data, int size, uint64_t timestampNs);
+    void writeFrames(const EmuTxRecord *batch, size_t n, TxLane lane);
+    void updateTxQueued();
+    void wakeTx();
+    bool probeRate(const QString &portName, const SerialConfig &config, QString &detail);
+
+    QSerialPort *serial;
+    QTimer *rxGapTimer;                // 殘留資料: 線路靜止後送出
+    int rxGapMs = APP_EMU_REMAIN_DATA_DELAY;
+    uint64_t rxHoldSinceNs = 0;        // first byte of the pending partial frame
+    bool rxHoldCapped = false;         // rxGapTimer cut short by the max hold
+    EmuFrameDecoder rxDecoder;
+    LatencyTracker latency;
+
+    SpscQueue<EmuTxRecord> txQueue;
+    SpscQueue<EmuTxRecord> bulkQueue;
+    SpscQueue<EmuRxRecord> rxQueue;
+    std::atomic<bool> txWakePending{false};
+    int partialLane = -1;              // lane in the middle of a burst (I/O thread)
+    bool bulkHeld = false;             // above the high water, wait for the low water
+    bool ctrlHeld = false;             // same for the control lane
+    std::atomic<bool> portOpen{false};
+    std::atomic<uint32_t> linkRate{0};
+    LinkStats stats;
+    std::atomic<EmuCaptureWriter::Source *> capture{nullptr};
+};
+
+#endif // SERIALWORKER_H
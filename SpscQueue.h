@@ -0,0 +1,79 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Lock-free single-producer / single-consumer ring queue.
+//
+// Exactly one thread may call push(), exactly one (other) thread may call
+// pop(). Capacity is rounded up to a power of two. Head and tail live on
+// separate cache lines so producer and consumer do not false-share.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacityPow2)
+    {
+        size_t capacity = 2;
+        while (capacity < capacityPow2)
+            capacity <<= 1;
+        slots.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Producer side
+    bool push(const T &value)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - cachedTail > mask) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h - cachedTail > mask)
+                return false;
+        }
+        slots[h & mask] = value;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, returns number of items copied to out
+    size_t pop(T *out, size_t maxCount)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (cachedHead == t)
+            cachedHead = head.load(std::memory_order_acquire);
+        size_t n = cachedHead - t;
+        if (n > maxCount)
+            n = maxCount;
+        for (size_t i = 0; i < n; ++i)
+            out[i] = slots[(t + i) & mask];
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    bool pop(T &out) { return pop(&out, 1) == 1; }
+
+    // Approximate, may be called from either side
+    size_t size() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;          // producer's copy of tail
+
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;          // consumer's copy of head
+};
+
+#endif // SPSCQUEUE_H
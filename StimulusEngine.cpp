@@ -0,0 +1,108 @@
+#include "StimulusEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "EmuLog.h"
+
+#define STIMULUS_STATUS_INTERVAL        (250)   //ms
+
+StimulusEngine::StimulusEngine(SerialWorker *worker, QObject *parent)
+    : QObject(parent)
+    , targets{worker}
+    , tickTimer(new QTimer(this))
+    , generator(StimulusConfig())
+{
+    qRegisterMetaType<StimulusEngine::Status>("StimulusEngine::Status");
+
+    tickTimer->setTimerType(Qt::PreciseTimer);
+    connect(tickTimer, &QTimer::timeout, this, &StimulusEngine::onTick);
+}
+
+void StimulusEngine::setTargets(const QVector<SerialWorker *> &workers)
+{
+    targets = workers;
+}
+
+bool StimulusEngine::targetsReady() const
+{
+    const size_t need = static_cast<size_t>(generator.framesPerUpdate());
+    bool any = false;
+    for (SerialWorker *w : targets) {
+        if (!w->isOpen())
+            continue;
+        if (w->txFree(SerialWorker::BulkLane) < need)
+            return false;
+        any = true;
+    }
+    return any;
+}
+
+uint32_t StimulusEngine::slowestLink() const
+{
+    uint32_t slowest = 0;
+    for (SerialWorker *w : targets) {
+        const uint32_t rate = w->linkBytesPerSec();
+        if (rate > 0 && (slowest == 0 || rate < slowest))
+            slowest = rate;
+    }
+    return slowest;
+}
+
+void StimulusEngine::start(const StimulusConfig &config)
+{
+    generator = StimulusGenerator(config);
+    frames.clear();
+    frames.reserve(static_cast<size_t>(generator.framesPerUpdate()));
+    stat = Status();
+    stat.demandBytesPerSec = generator.requiredBytesPerSec();
+
+    const int intervalMs = std::max(1, static_cast<int>(std::lround(1000.0 / generator.config().updateHz)));
+    tickTimer->start(intervalMs);
+    clock.start();
+    lastStatusMs = 0;
+    onTick();
+}
+
+void StimulusEngine::stop()
+{
+    if (!tickTimer->isActive())
+        return;
+    tickTimer->stop();
+    publishStatus();
+    emit stopped();
+}
+
+void StimulusEngine::onTick()
+{
+    const qint64 nowMs = clock.elapsed();
+
+    if (!targetsReady()) {
+        // 來不及送出就丟掉這次更新 (所有埠一起丟)，不累積延遲
+        ++stat.skipped;
+    } else {
+        frames.clear();
+        generator.generate(static_cast<double>(nowMs) / 1000.0, frames);
+        for (SerialWorker *w : targets) {
+            if (!w->isOpen())
+                continue;
+            for (const EmuFrame::Frame &f : frames)
+                w->postTx(f.data(), static_cast<int>(f.size()), SerialWorker::BulkLane);
+        }
+        for (const EmuFrame::Frame &f : frames)
+            EmuLog_Traffic("STIM", f.data(), static_cast<int>(f.size()));
+        ++stat.updates;
+        stat.frames += frames.size();
+    }
+
+    if (nowMs - lastStatusMs >= STIMULUS_STATUS_INTERVAL) {
+        lastStatusMs = nowMs;
+        publishStatus();
+    }
+}
+
+void StimulusEngine::publishStatus()
+{
+    stat.linkBytesPerSec = slowestLink();
+    emit statusUpdated(stat);
+}
@@ -0,0 +1,72 @@
+#ifndef STIMULUSENGINE_H
+#define STIMULUSENGINE_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include <cstdint>
+#include <vector>
+
+#include "SerialWorker.h"
+#include "StimulusGenerator.h"
+
+// Streams StimulusGenerator updates into the bulk TX lane of one or more
+// workers.
+//
+// Runs on its own QThread so frame generation never competes with the GUI
+// or the serial I/O threads. Each update is generated once from a single
+// clock and posted to every open target port, so all boards see the same
+// waveform on the same time base. An update that does not fit in every
+// target's bulk lane is skipped on all of them rather than queued, so the
+// stimulus stays aligned with wall-clock time; skipped updates and the
+// demand / link ratio (slowest port) are reported through statusUpdated().
+class StimulusEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StimulusEngine(SerialWorker *worker, QObject *parent = nullptr);
+
+    // Engine thread; the engine is the only bulk lane producer of each target
+    void setTargets(const QVector<SerialWorker *> &workers);
+
+    struct Status
+    {
+        quint64 updates = 0;        // updates fully queued
+        quint64 frames = 0;         // frames queued
+        quint64 skipped = 0;        // updates dropped, link could not keep up
+        double demandBytesPerSec = 0.0;
+        double linkBytesPerSec = 0.0;
+    };
+
+public slots:
+    void start(const StimulusConfig &config);
+    void stop();
+
+signals:
+    void statusUpdated(const StimulusEngine::Status &status);
+    void stopped();
+
+private slots:
+    void onTick();
+
+private:
+    void publishStatus();
+
+    bool targetsReady() const;
+    uint32_t slowestLink() const;
+
+    QVector<SerialWorker *> targets;
+    QTimer *tickTimer;
+    QElapsedTimer clock;
+    StimulusGenerator generator;
+    std::vector<EmuFrame::Frame> frames;
+    Status stat;
+    qint64 lastStatusMs = 0;
+};
+
+Q_DECLARE_METATYPE(StimulusEngine::Status)
+
+#endif // STIMULUSENGINE_H
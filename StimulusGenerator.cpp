@@ -0,0 +1,127 @@
+#include "StimulusGenerator.h"
+
+#include <cmath>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kChannels = EmuChainModel::kCellChannels + EmuChainModel::kAuxChannels;
+
+// Deterministic hash -> [-1, 1), so a given cell keeps its imbalance offset
+double unitHash(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return static_cast<double>(x) / 2147483648.0 - 1.0;
+}
+
+} // namespace
+
+StimulusGenerator::StimulusGenerator(const StimulusConfig &config)
+    : cfg(config)
+{
+    if (cfg.afeCount < 1)
+        cfg.afeCount = 1;
+    if (cfg.periodS <= 0.0)
+        cfg.periodS = 1.0;
+    if (cfg.updateHz <= 0.0)
+        cfg.updateHz = 1.0;
+
+    // 不平衡偏移量固定，只算一次
+    chain.resize(cfg.afeCount);
+    offsets.resize(static_cast<size_t>(kChannels) * static_cast<size_t>(cfg.afeCount));
+    for (int ch = 0; ch < kChannels; ++ch)
+        for (int afe = 0; afe < cfg.afeCount; ++afe)
+            offsets[static_cast<size_t>(ch) * static_cast<size_t>(cfg.afeCount) + static_cast<size_t>(afe)] =
+                channelOffset(afe, ch);
+}
+
+int StimulusGenerator::groupsPerAfe() const
+{
+    return (cfg.cells ? kCellGroups : 0) + (cfg.aux ? kAuxGroups : 0);
+}
+
+double StimulusGenerator::requiredBytesPerSec() const
+{
+    return static_cast<double>(framesPerUpdate()) * APP_EMU_UART_PACKET_LEN * cfg.updateHz;
+}
+
+uint16_t StimulusGenerator::voltageToCode(double volts)
+{
+    const double code = (volts * 1000000.0 - 1500000.0) / 150.0;
+    if (code <= 0.0)
+        return 0;
+    if (code >= 65535.0)
+        return 0xFFFF;
+    return static_cast<uint16_t>(code);
+}
+
+double StimulusGenerator::profileAt(double t)
+{
+    const double phase = std::fmod(t / cfg.periodS, 1.0);
+    switch (cfg.profile) {
+    case StimulusConfig::Ramp:
+        return cfg.amplitudeV * phase;
+    case StimulusConfig::Sine:
+        return cfg.amplitudeV * std::sin(2.0 * kPi * phase);
+    case StimulusConfig::Step:
+        return phase < 0.5 ? 0.0 : cfg.amplitudeV;
+    case StimulusConfig::Noise:
+        return noise();
+    }
+    return 0.0;
+}
+
+double StimulusGenerator::noise()
+{
+    // xorshift32, one draw per channel
+    noiseState ^= noiseState << 13;
+    noiseState ^= noiseState >> 17;
+    noiseState ^= noiseState << 5;
+    return cfg.amplitudeV * (static_cast<double>(noiseState) / 2147483648.0 - 1.0);
+}
+
+double StimulusGenerator::channelOffset(int afe, int channel) const
+{
+    if (cfg.imbalanceV == 0.0)
+        return 0.0;
+    return cfg.imbalanceV * unitHash(static_cast<uint32_t>(afe) * 64u + static_cast<uint32_t>(channel));
+}
+
+double StimulusGenerator::voltageAt(int afe, int channel, double t)
+{
+    return cfg.baseV + profileAt(t) + channelOffset(afe, channel);
+}
+
+void StimulusGenerator::fillChannels(double *volts, const double *offset, double profile, int channels)
+{
+    const size_t n = static_cast<size_t>(channels) * static_cast<size_t>(cfg.afeCount);
+    if (cfg.profile == StimulusConfig::Noise) {
+        for (size_t i = 0; i < n; ++i)
+            volts[i] = cfg.baseV + noise() + offset[i];
+        return;
+    }
+    const double v = cfg.baseV + profile;
+    for (size_t i = 0; i < n; ++i)
+        volts[i] = v + offset[i];
+}
+
+size_t StimulusGenerator::generate(double t, std::vector<EmuFrame::Frame> &out)
+{
+    // 波形每次更新只算一次 (cells 與 aux 共用)，雜訊則每個通道各取一次
+    const double profile = (cfg.profile == StimulusConfig::Noise) ? 0.0 : profileAt(t);
+    uint32_t groups = 0;
+    if (cfg.cells) {
+        fillChannels(chain.cellVolts(0), offsets.data(), profile, EmuChainModel::kCellChannels);
+        groups |= EmuChainModel::kCellGroupsMask;
+    }
+    if (cfg.aux) {
+        fillChannels(chain.auxVolts(0), offsets.data() + EmuChainModel::kCellChannels * cfg.afeCount, profile,
+                     EmuChainModel::kAuxChannels);
+        groups |= EmuChainModel::kAuxGroupsMask;
+    }
+    return chain.generate(groups, out);
+}
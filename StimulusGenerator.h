@@ -0,0 +1,74 @@
+#ifndef STIMULUSGENERATOR_H
+#define STIMULUSGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EmuChainModel.h"
+#include "EmuFrame.h"
+
+// Time-varying cell / aux voltage stimulus for the whole AFE chain.
+//
+// Each update produces one register group frame per selected group per AFE
+// (RDCVA~F carry 18 cells, RDAUXA~E carry 15 aux channels). Ramp, sine and
+// step are evaluated once per update and shared by every channel, noise is
+// drawn per channel; a fixed per-channel offset (precomputed) models cell
+// imbalance. Voltages are written into an EmuChainModel, which converts and
+// encodes the whole chain in bulk. Qt-free, so both the GUI and headless
+// mode drive it.
+struct StimulusConfig
+{
+    enum Profile { Ramp, Sine, Step, Noise };
+
+    Profile profile = Sine;
+    int afeCount = 1;
+    double baseV = 3.6;          // V
+    double amplitudeV = 0.1;     // V (ramp: span, sine/step/noise: peak)
+    double periodS = 1.0;        // s, ramp/sine/step period
+    double imbalanceV = 0.0;     // V, per-channel offset in [-imbalance, +imbalance]
+    double updateHz = 10.0;      // full-chain updates per second
+    bool cells = true;           // RDCVA~F
+    bool aux = false;            // RDAUXA~E
+};
+
+class StimulusGenerator
+{
+public:
+    static constexpr int kCellGroups = 6;
+    static constexpr int kAuxGroups = 5;
+    static constexpr int kChannelsPerGroup = 3;
+
+    explicit StimulusGenerator(const StimulusConfig &config);
+
+    const StimulusConfig &config() const { return cfg; }
+
+    int groupsPerAfe() const;
+    int framesPerUpdate() const { return groupsPerAfe() * cfg.afeCount; }
+
+    // Serial bytes needed per second at the configured update rate
+    double requiredBytesPerSec() const;
+
+    // Voltage (V) of channel `channel` (0..17 cells, 18..32 aux) of `afe` at t;
+    // single point query, generate() does not go through it
+    double voltageAt(int afe, int channel, double t);
+
+    // All frames of one update at time t, appended to out; returns the count
+    size_t generate(double t, std::vector<EmuFrame::Frame> &out);
+
+    // (V - 1.5V) / 150uV, clamped to the 16-bit register range
+    static uint16_t voltageToCode(double volts);
+
+private:
+    double profileAt(double t);
+    double noise();
+    double channelOffset(int afe, int channel) const;
+    void fillChannels(double *volts, const double *offset, double profile, int channels);
+
+    StimulusConfig cfg;
+    uint32_t noiseState = 0x12345678u;
+    EmuChainModel chain;
+    std::vector<double> offsets;    // [channel][afe] imbalance, cells then aux
+};
+
+#endif // STIMULUSGENERATOR_H
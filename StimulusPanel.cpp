@@ -0,0 +1,128 @@
+#include "StimulusPanel.h"
+
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+#include "EmuProtocol.h"
+
+StimulusPanel::StimulusPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    comboProfile = new QComboBox(this);
+    comboProfile->addItem("Ramp", StimulusConfig::Ramp);
+    comboProfile->addItem("Sine", StimulusConfig::Sine);
+    comboProfile->addItem("Step", StimulusConfig::Step);
+    comboProfile->addItem("Noise", StimulusConfig::Noise);
+    comboProfile->setCurrentIndex(1);
+
+    const StimulusConfig def;
+
+    spinAfeCount = new QSpinBox(this);
+    spinAfeCount->setRange(1, APP_AFECASE_NUM_MAX);
+    spinAfeCount->setValue(def.afeCount);
+
+    auto makeSpin = [this](double min, double max, double value, int decimals, const QString &suffix) {
+        QDoubleSpinBox *spin = new QDoubleSpinBox(this);
+        spin->setRange(min, max);
+        spin->setDecimals(decimals);
+        spin->setValue(value);
+        spin->setSuffix(suffix);
+        return spin;
+    };
+    spinBaseV = makeSpin(0.0, 5.0, def.baseV, 4, " V");
+    spinAmplitudeV = makeSpin(0.0, 5.0, def.amplitudeV, 4, " V");
+    spinPeriodS = makeSpin(0.01, 3600.0, def.periodS, 2, " s");
+    spinImbalanceV = makeSpin(0.0, 1.0, def.imbalanceV, 4, " V");
+    spinUpdateHz = makeSpin(0.1, 1000.0, def.updateHz, 1, " Hz");
+
+    checkCells = new QCheckBox("Cells (RDCVA~F)", this);
+    checkCells->setChecked(def.cells);
+    checkAux = new QCheckBox("Aux (RDAUXA~E)", this);
+    checkAux->setChecked(def.aux);
+
+    btnStartStop = new QPushButton("Start", this);
+    labelDemand = new QLabel(this);
+    labelStatus = new QLabel(this);
+
+    QHBoxLayout *groups = new QHBoxLayout();
+    groups->addWidget(checkCells);
+    groups->addWidget(checkAux);
+    groups->addStretch();
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Profile", comboProfile);
+    form->addRow("AFE Count", spinAfeCount);
+    form->addRow("Base Voltage", spinBaseV);
+    form->addRow("Amplitude", spinAmplitudeV);
+    form->addRow("Period", spinPeriodS);
+    form->addRow("Cell Imbalance", spinImbalanceV);
+    form->addRow("Update Rate", spinUpdateHz);
+    form->addRow("Register Groups", groups);
+    form->addRow("Demand", labelDemand);
+    form->addRow("Status", labelStatus);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(form);
+    layout->addWidget(btnStartStop, 0, Qt::AlignLeft);
+    layout->addStretch();
+
+    connect(btnStartStop, &QPushButton::clicked, this, [this]() {
+        if (running)
+            emit stopRequested();
+        else
+            emit startRequested(config());
+    });
+
+    connect(spinAfeCount, QOverload<int>::of(&QSpinBox::valueChanged), this, &StimulusPanel::updateDemand);
+    connect(spinUpdateHz, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &StimulusPanel::updateDemand);
+    connect(checkCells, &QCheckBox::toggled, this, &StimulusPanel::updateDemand);
+    connect(checkAux, &QCheckBox::toggled, this, &StimulusPanel::updateDemand);
+    updateDemand();
+}
+
+StimulusConfig StimulusPanel::config() const
+{
+    StimulusConfig c;
+    c.profile = static_cast<StimulusConfig::Profile>(comboProfile->currentData().toInt());
+    c.afeCount = spinAfeCount->value();
+    c.baseV = spinBaseV->value();
+    c.amplitudeV = spinAmplitudeV->value();
+    c.periodS = spinPeriodS->value();
+    c.imbalanceV = spinImbalanceV->value();
+    c.updateHz = spinUpdateHz->value();
+    c.cells = checkCells->isChecked();
+    c.aux = checkAux->isChecked();
+    return c;
+}
+
+void StimulusPanel::setRunning(bool run)
+{
+    running = run;
+    btnStartStop->setText(run ? "Stop" : "Start");
+}
+
+void StimulusPanel::updateDemand()
+{
+    const StimulusGenerator gen(config());
+    labelDemand->setText(QString("%1 frames/update, %2 bytes/s")
+                             .arg(gen.framesPerUpdate())
+                             .arg(gen.requiredBytesPerSec(), 0, 'f', 0));
+}
+
+void StimulusPanel::setStatus(const StimulusEngine::Status &status)
+{
+    QString text = QString("updates %1, frames %2, skipped %3")
+                       .arg(status.updates).arg(status.frames).arg(status.skipped);
+
+    // 需求超過鏈路頻寬時提示 (8N1: baud / 10 bytes/s)
+    const bool overload = status.linkBytesPerSec > 0.0 &&
+                          status.demandBytesPerSec > status.linkBytesPerSec;
+    if (overload) {
+        text += QString("\nLink cannot keep up: needs %1 bytes/s, link %2 bytes/s")
+                    .arg(status.demandBytesPerSec, 0, 'f', 0)
+                    .arg(status.linkBytesPerSec, 0, 'f', 0);
+    }
+    labelStatus->setStyleSheet((overload || status.skipped > 0) ? "color: darkred;" : QString());
+    labelStatus->setText(text);
+}
@@ -0,0 +1,52 @@
+#ifndef STIMULUSPANEL_H
+#define STIMULUSPANEL_H
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QWidget>
+
+#include "StimulusEngine.h"
+#include "StimulusGenerator.h"
+
+// "Stimulus" tab: edits a StimulusConfig and shows the engine status
+class StimulusPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StimulusPanel(QWidget *parent = nullptr);
+
+    StimulusConfig config() const;
+
+public slots:
+    void setRunning(bool running);
+    void setStatus(const StimulusEngine::Status &status);
+
+signals:
+    void startRequested(const StimulusConfig &config);
+    void stopRequested();
+
+private slots:
+    void updateDemand();
+
+private:
+    QComboBox *comboProfile;
+    QSpinBox *spinAfeCount;
+    QDoubleSpinBox *spinBaseV;
+    QDoubleSpinBox *spinAmplitudeV;
+    QDoubleSpinBox *spinPeriodS;
+    QDoubleSpinBox *spinImbalanceV;
+    QDoubleSpinBox *spinUpdateHz;
+    QCheckBox *checkCells;
+    QCheckBox *checkAux;
+    QPushButton *btnStartStop;
+    QLabel *labelDemand;
+    QLabel *labelStatus;
+    bool running = false;
+};
+
+#endif // STIMULUSPANEL_H
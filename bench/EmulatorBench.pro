@@ -0,0 +1,14 @@
+# CRC / framing micro-benchmark, console only (no serial port, no GUI).
+#   ./EmulatorBench [seconds-per-variant]   (0 = checks only)
+# Exit code is non-zero when any engine disagrees with the reference.
+
+TEMPLATE = app
+TARGET = EmulatorBench
+
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+include(../emucore.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,604 @@
+// EmulatorBench - CRC15/CRC10 and 16 bytes framing micro-benchmark.
+//
+// Runs headless, without a serial port. Every engine is first checked against
+// the reference implementations (Pec15_Calc, pec10_calc_bitwise) with golden
+// vectors and random buffers; the timings are only printed afterwards.
+
+#include "EmuCellHistory.h"
+#include "EmuChainModel.h"
+#include "EmuFirmwareModel.h"
+#include "EmuFrame.h"
+#include "EmuProtocol.h"
+#include "EmuRegisterDecoder.h"
+#include "HexFormat.h"
+#include "LatencyTracker.h"
+#include "LibCrc15Crc10TableCalc.h"
+#include "LibPecBatchCalc.h"
+#include "StimulusGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int g_failures = 0;
+double g_minSeconds = 0.05;
+volatile uint32_t g_sink = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok) {
+        ++g_failures;
+        std::printf("FAIL  %s\n", what);
+    }
+}
+
+/* Golden vectors ----------------------------------------------------------*/
+void checkGolden()
+{
+    // LTC/ADBMS datasheet command PECs
+    uint8_t wrcfga[2] = {0x00, 0x01};
+    uint8_t rdcva[2]  = {0x00, 0x04};
+    check(Pec15_Calc(2, wrcfga) == 0x3D6E, "Pec15_Calc(WRCFGA) == 0x3D6E");
+    check(Pec15_Calc(2, rdcva) == 0x07C2, "Pec15_Calc(RDCVA) == 0x07C2");
+
+    // DPEC examples documented in LibCrc15Crc10TableCalc.c
+    uint8_t ex1[7] = {0x00, 0x80, 0x00, 0x80, 0x00, 0x80, 0x00};
+    uint8_t ex2[7] = {0x01, 0x00, 0x00, 0xFF, 0x03, 0x00, 0x00};
+    typedef uint16_t (*Pec10Fn)(bool, int, uint8_t *);
+    const Pec10Fn pec10[] = {pec10_calc_bitwise, pec10_calc_table, pec10_calc_slice4, pec10_calc_slice8, pec10_calc};
+    for (Pec10Fn fn : pec10) {
+        check(fn(true, 6, ex1) == 0x02CE, "pec10 Example1 == 0x02CE");
+        check(fn(true, 6, ex2) == 0x005A, "pec10 Example2 == 0x005A");
+    }
+
+    // RDCVA packet for AFE1, data [00 80 00 80 00 80]
+    const uint8_t cmd[4] = {0x00, 0x00, 0x00, 0x04};
+    uint8_t packet[APP_EMU_UART_PACKET_LEN] = {0};
+    EmuProtocol_BuildRegPacket(packet, cmd, 0, ex1, true);
+    const uint8_t expect[APP_EMU_UART_PACKET_LEN] = {0x55, 0xAA, 0x00, 0x00, 0x00, 0x04, 0x00,
+                                                     0x00, 0x80, 0x00, 0x80, 0x00, 0x80, 0x02, 0xCE, 0x53};
+    check(std::memcmp(packet, expect, sizeof(expect)) == 0, "RDCVA packet bytes");
+    const EmuFrame::Frame frame = EmuFrame::encodeRegGroup<SPI_CMD_RDCVA>(0, ex1);
+    check(std::memcmp(frame.data(), expect, sizeof(expect)) == 0, "EmuFrame RDCVA packet bytes");
+
+    // AFE indexes past 255 round-trip through decode
+    EmuFrame::Decoded d;
+    check(EmuFrame::decode(EmuFrame::encodeRegGroup<SPI_CMD_RDCVB>(1000, ex1), d) == EmuFrame::Status::Ok &&
+              d.afeIndex == 1000, "RDCVB AFE index 1000");
+    check(EmuFrame::decode(EmuFrame::encodeAfeTotal(768, true), d) == EmuFrame::Status::Ok &&
+              d.afeTotal() == 768 && d.initDevice(), "AFE total 768");
+    check(EmuFrame::decode(EmuFrame::encodeRangeVoltage(0x11, 300, 1023, 0x1234, 7), d) == EmuFrame::Status::Ok &&
+              d.rangeStartIndex() == 300 && d.rangeEndIndex() == 1023 && d.rangeStart() == 0x1234 &&
+              d.rangeStep() == 7, "range voltage AFE 300~1023");
+
+    // 3.3V -> (3.3 - 1.5) / 150uV = 12000 = 0x2EE0
+    uint8_t code[2];
+    EmuProtocol_VoltageToBytes(3300000.0, code);
+    check(code[0] == 0xE0 && code[1] == 0x2E, "voltage_to_bytes(3.3V) == E0 2E");
+}
+
+/* Random cross-check of every engine against the reference ----------------*/
+void checkRandom()
+{
+    std::mt19937 rng(12345);
+    const PecBatchEngine_t engines[] = {PEC_BATCH_ENGINE_SCALAR, PEC_BATCH_ENGINE_AVX2};
+
+    for (int it = 0; it < 2000; ++it) {
+        const int len = static_cast<int>(rng() % 200);
+        const size_t stride = static_cast<size_t>(len) + 1 + rng() % 4;
+        const size_t count = rng() % 40;
+        const bool cmdCnt = (rng() & 1u) != 0;
+        std::vector<uint8_t> buf(count * stride + 1);
+        for (uint8_t &b : buf)
+            b = static_cast<uint8_t>(rng());
+
+        for (size_t k = 0; k < count; ++k) {
+            uint8_t *p = buf.data() + k * stride;
+            const uint16_t ref = pec10_calc_bitwise(cmdCnt, len, p);
+            check(pec10_calc_table(cmdCnt, len, p) == ref, "pec10_calc_table vs reference");
+            check(pec10_calc_slice4(cmdCnt, len, p) == ref, "pec10_calc_slice4 vs reference");
+            check(pec10_calc_slice8(cmdCnt, len, p) == ref, "pec10_calc_slice8 vs reference");
+        }
+
+        std::vector<uint16_t> out10(count), out15(count);
+        for (PecBatchEngine_t engine : engines) {
+            PecBatch_SetEngine(engine);
+            pec10_calc_batch(cmdCnt, len, buf.data(), stride, count, out10.data());
+            Pec15_CalcBatch(static_cast<uint8_t>(len), buf.data(), stride, count, out15.data());
+            for (size_t k = 0; k < count; ++k) {
+                uint8_t *p = buf.data() + k * stride;
+                check(out10[k] == pec10_calc_bitwise(cmdCnt, len, p), "pec10_calc_batch vs reference");
+                check(out15[k] == Pec15_Calc(static_cast<uint8_t>(len), p), "Pec15_CalcBatch vs reference");
+            }
+        }
+    }
+    PecBatch_SetEngine(PEC_BATCH_ENGINE_AUTO);
+}
+
+/* Chain model against the per-frame encoder ------------------------------*/
+void checkChainModel()
+{
+    std::mt19937 rng(777);
+    std::uniform_real_distribution<double> volts(1.0, 12.0);     // beyond both clamps
+    const int afeCount = 300;       // past 256: AFE index high byte in CMD2
+
+    EmuChainModel chain(afeCount);
+    for (int ch = 0; ch < EmuChainModel::kCellChannels; ++ch)
+        for (int afe = 0; afe < afeCount; ++afe)
+            chain.cellVolts(ch)[afe] = volts(rng);
+    for (int ch = 0; ch < EmuChainModel::kAuxChannels; ++ch)
+        for (int afe = 0; afe < afeCount; ++afe)
+            chain.auxVolts(ch)[afe] = volts(rng);
+    for (int afe = 0; afe < afeCount; ++afe)
+        for (int g = 0; g < EmuChainModel::kCfgGroups; ++g)
+            for (int i = 0; i < EmuFrame::kRegDataLen; ++i)
+                chain.config(afe, g)[i] = static_cast<uint8_t>(rng());
+
+    std::vector<EmuFrame::Frame> frames;
+    const uint32_t all = EmuChainModel::kCellGroupsMask | EmuChainModel::kAuxGroupsMask | EmuChainModel::kCfgGroupsMask;
+    check(chain.generate(all, frames) == static_cast<size_t>(afeCount * EmuFrame::kRegGroupCount),
+          "EmuChainModel frame count");
+
+    bool same = frames.size() == static_cast<size_t>(afeCount * EmuFrame::kRegGroupCount);
+    for (int afe = 0; same && afe < afeCount; ++afe) {
+        for (int g = 0; g < EmuFrame::kRegGroupCount; ++g) {
+            uint8_t data[EmuFrame::kRegDataLen];
+            if (g >= 11) {
+                std::memcpy(data, chain.config(afe, g - 11), sizeof(data));
+            } else {
+                const double *base = (g < 6) ? chain.cellVolts(g * 3) : chain.auxVolts((g - 6) * 3);
+                for (int i = 0; i < 3; ++i) {
+                    const uint16_t code = StimulusGenerator::voltageToCode(base[i * afeCount + afe]);
+                    data[2 * i] = static_cast<uint8_t>(code & 0xFF);
+                    data[2 * i + 1] = static_cast<uint8_t>(code >> 8);
+                }
+            }
+            const EmuFrame::Frame ref = EmuFrame::kRegGroups[g].encode(static_cast<uint16_t>(afe), data, true);
+            same = same && ref == frames[static_cast<size_t>(afe * EmuFrame::kRegGroupCount + g)];
+        }
+    }
+    check(same, "EmuChainModel::generate vs encodeRegGroup");
+}
+
+/* Burst frames against single frames ------------------------------------*/
+void checkBurst()
+{
+    std::mt19937 rng(4242);
+    const int afeCount = 300;
+    EmuChainModel chain(afeCount);
+    for (int ch = 0; ch < EmuChainModel::kCellChannels; ++ch)
+        for (int afe = 0; afe < afeCount; ++afe)
+            chain.cellVolts(ch)[afe] = 2.0 + (rng() % 20000) * 1e-4;
+    for (int afe = 0; afe < afeCount; ++afe)
+        for (int g = 0; g < EmuChainModel::kCfgGroups; ++g)
+            for (int i = 0; i < EmuFrame::kRegDataLen; ++i)
+                chain.config(afe, g)[i] = static_cast<uint8_t>(rng());
+
+    // Cells + config: two runs of groups, 300 AFEs split over several bursts
+    const uint32_t mask = EmuChainModel::kCellGroupsMask | EmuChainModel::kCfgGroupsMask;
+    std::vector<EmuFrame::Frame> frames;
+    std::vector<uint8_t> bursts;
+    chain.generate(mask, frames);
+    const size_t burstCount = chain.generateBursts(mask, bursts);
+
+    EmuFirmwareModel single, burst;
+    std::vector<EmuFrame::Frame> responses;
+    for (const EmuFrame::Frame &f : frames)
+        single.feed(f.data(), f.size(), responses);
+    responses.clear();
+    for (size_t at = 0; at < bursts.size();) {       // uneven UART reads
+        const size_t n = std::min<size_t>(1 + rng() % 700, bursts.size() - at);
+        burst.feed(bursts.data() + at, n, responses);
+        at += n;
+    }
+
+    bool same = true;
+    for (int afe = 0; afe < afeCount; ++afe)
+        for (int g = 0; g < EmuFrame::kRegGroupCount; ++g)
+            same = same && std::memcmp(single.registers(afe, g), burst.registers(afe, g), EmuFrame::kRegDataLen) == 0;
+    check(same, "burst registers vs single frames");
+    check(burst.stats().bursts == burstCount && responses.size() == burstCount, "burst acknowledged once");
+    EmuFrame::Decoded ack;
+    check(!responses.empty() && EmuFrame::decode(responses[0], ack) == EmuFrame::Status::Ok &&
+              ack.cmd == APP_CMD_AFE_BURST && ack.burstLength() == 0 && ack.burstDropped() == 0,
+          "burst ack");
+    check(bursts.size() * 10 < frames.size() * APP_EMU_UART_PACKET_LEN * 6, "burst wire size");
+
+    // One bad record is dropped alone, the rest of the burst is stored
+    uint8_t codes[EmuFrame::kRegGroupCount * EmuFrame::kRegDataLen];
+    for (uint8_t &b : codes)
+        b = static_cast<uint8_t>(rng());
+    uint8_t out[APP_EMU_BURST_FRAME_MAX];
+    const size_t size = EmuFrame::encodeBurst(700, 1, 0, EmuFrame::kRegGroupCount, codes, out);
+    check(size == APP_EMU_UART_PACKET_LEN + EmuFrame::kRegGroupCount * EmuFrame::kBurstRecordLen, "encodeBurst size");
+    out[APP_EMU_UART_PACKET_LEN + 3 * EmuFrame::kBurstRecordLen + 7] ^= 0x01;     // DPEC2 of RDCVD
+    out[APP_EMU_A_DATA + 6] = EmuFrame::burstPayloadSum(out + APP_EMU_UART_PACKET_LEN, static_cast<int>(size) - APP_EMU_UART_PACKET_LEN);
+    out[APP_EMU_A_CHECKSUM] = EmuFrame::checksum(out);
+    responses.clear();
+    burst.feed(out, size, responses);
+    check(responses.size() == 1 && EmuFrame::decode(responses[0], ack) == EmuFrame::Status::Ok &&
+              ack.burstDropped() == 1 && ack.afeIndex == 700,
+          "burst bad record dropped");
+    const uint8_t zero[EmuFrame::kRegDataLen] = {};
+    check(std::memcmp(burst.registers(700, 2), codes + 2 * EmuFrame::kRegDataLen, EmuFrame::kRegDataLen) == 0 &&
+              std::memcmp(burst.registers(700, 3), zero, EmuFrame::kRegDataLen) == 0,
+          "burst good records stored");
+}
+
+/* Typed RX decode of frames and bursts ------------------------------------*/
+void checkRegisterDecoder()
+{
+    std::mt19937 rng(99);
+    const int afeCount = 300;
+    EmuChainModel chain(afeCount);
+    for (int ch = 0; ch < EmuChainModel::kCellChannels; ++ch)
+        for (int afe = 0; afe < afeCount; ++afe)
+            chain.cellVolts(ch)[afe] = 1.5 + (rng() % 65536) * 150e-6;
+    for (int ch = 0; ch < EmuChainModel::kAuxChannels; ++ch)
+        for (int afe = 0; afe < afeCount; ++afe)
+            chain.auxVolts(ch)[afe] = 1.5 + (rng() % 65536) * 150e-6;
+    for (int afe = 0; afe < afeCount; ++afe)
+        for (int g = 0; g < EmuChainModel::kCfgGroups; ++g)
+            for (int i = 0; i < EmuFrame::kRegDataLen; ++i)
+                chain.config(afe, g)[i] = static_cast<uint8_t>(rng());
+
+    const uint32_t all = EmuChainModel::kCellGroupsMask | EmuChainModel::kAuxGroupsMask | EmuChainModel::kCfgGroupsMask;
+    std::vector<EmuFrame::Frame> frames;
+    std::vector<uint8_t> bursts;
+    chain.generate(all, frames);
+    chain.generateBursts(all, bursts);
+    frames[5][APP_EMU_A_DPEC2] ^= 0x01;     // AFE 0 RDCVF: dropped, stays NaN
+    frames[5][APP_EMU_A_CHECKSUM] = EmuFrame::checksum(frames[5].data());
+
+    // Single frames in one batch; bursts as the 16 bytes RX pieces
+    EmuRegisterDecoder single, burst;
+    for (const EmuFrame::Frame &f : frames)
+        single.addFrame(f.data(), static_cast<int>(f.size()));
+    check(single.flush() == frames.size() - 1 && single.stats().dpecErrors == 1 && single.dpecErrors(0, 5) == 1,
+          "EmuRegisterDecoder DPEC");
+    for (size_t at = 0; at < bursts.size();) {
+        const int len = EmuFrame::burstPayloadLen(&bursts[at]);
+        burst.addFrame(&bursts[at], APP_EMU_UART_PACKET_LEN);
+        for (int i = 0; i < len; i += APP_EMU_UART_PACKET_LEN) {
+            burst.addBurstData(&bursts[at + APP_EMU_UART_PACKET_LEN + static_cast<size_t>(i)],
+                               std::min(APP_EMU_UART_PACKET_LEN, len - i));
+            if (rng() % 8 == 0)
+                burst.flush();      // batches ending inside a burst
+        }
+        at += APP_EMU_UART_PACKET_LEN + static_cast<size_t>(len);
+    }
+    burst.flush();
+    check(burst.afeCount() == afeCount && burst.stats().records == frames.size(), "EmuRegisterDecoder bursts");
+
+    // Decoded value = the code the chain model sent, x 150uV + 1.5V
+    auto sent = [](double v) { return StimulusGenerator::voltageToCode(v) * 150e-6 + 1.5; };
+    auto near = [](double a, double b) { return std::fabs(a - b) < 1e-9; };
+    bool same = std::isnan(single.cellVolts(15)[0]);
+    for (int afe = 0; afe < afeCount; ++afe) {
+        for (int ch = 0; ch < EmuChainModel::kCellChannels; ++ch) {
+            const double v = sent(chain.cellVolts(ch)[afe]);
+            same = same && near(burst.cellVolts(ch)[afe], v) && (near(single.cellVolts(ch)[afe], v) || (afe == 0 && ch >= 15));
+        }
+        for (int ch = 0; ch < EmuChainModel::kAuxChannels; ++ch) {
+            const double v = sent(chain.auxVolts(ch)[afe]);
+            same = same && near(burst.auxVolts(ch)[afe], v) && near(single.auxVolts(ch)[afe], v);
+        }
+        for (int g = 0; g < EmuChainModel::kCfgGroups; ++g)
+            same = same && std::memcmp(burst.config(afe, g), chain.config(afe, g), EmuFrame::kRegDataLen) == 0;
+    }
+    check(same, "EmuRegisterDecoder values vs chain model");
+}
+
+/* Partial frame hold of a slow burst ---------------------------------------*/
+void checkBurstHold()
+{
+    // Largest burst trickled one byte per character time at 115200 8N1, with
+    // SerialWorker's rule: the hold starts at the first pending byte, restarts
+    // when the decoder consumes bytes, and ends at holdLimitNs()
+    const uint32_t bytesPerSec = 115200 / 10;
+    const uint64_t byteNs = 1000000000ull / bytesPerSec;
+    const uint64_t baseNs = static_cast<uint64_t>(APP_EMU_REMAIN_DATA_DELAY) * 1000000u;
+    std::vector<uint8_t> regs(EmuFrame::kBurstMaxRecords * EmuFrame::kRegDataLen);
+    for (size_t i = 0; i < regs.size(); ++i)
+        regs[i] = static_cast<uint8_t>(i * 7);
+    uint8_t burst[APP_EMU_BURST_FRAME_MAX];
+    const size_t size = EmuFrame::encodeBurst(0, EmuFrame::kBurstMaxRecords / 4, 0, 4, regs.data(), burst);
+    check(size == APP_EMU_BURST_FRAME_MAX && size * byteNs > baseNs, "max burst outlasts the base hold");
+
+    EmuFrameDecoder decoder;
+    EmuFrameDecoder::Item item;
+    uint64_t holdSince = 0;
+    bool flushed = false;
+    int whole = 0;
+    for (size_t i = 0; i < size && !flushed; ++i) {
+        const uint64_t now = i * byteNs;
+        const size_t before = decoder.pending();
+        decoder.write(&burst[i], 1);
+        while (decoder.next(item))
+            whole += (item.kind == EmuFrameDecoder::Item::Frame && item.size == static_cast<int>(size));
+        if (decoder.pending() == 0)
+            continue;
+        if (before == 0 || before + 1 > decoder.pending())
+            holdSince = now;
+        flushed = now - holdSince > decoder.holdLimitNs(baseNs, bytesPerSec);
+    }
+    check(!flushed && whole == 1 && decoder.pending() == 0, "slow max burst not cut by the hold");
+}
+
+/* Unanswered requests -----------------------------------------------------*/
+void checkLatencyTimeout()
+{
+    // AFE 0 and 1 RDCVA at t = 0, only AFE 0 answered: AFE 1 is counted as
+    // unanswered once a snapshot is taken past kTimeoutNs, and only once
+    LatencyTracker tracker;
+    EmuFrame::Frame afe0 = EmuFrame::prefix(SPI_CMD_RDCVA);
+    EmuFrame::Frame afe1 = afe0;
+    afe1[APP_EMU_A_AFEINDEX] = 1;
+    tracker.onTx(afe0.data(), 0);
+    tracker.onTx(afe1.data(), 0);
+    const bool matched = tracker.onRx(afe0.data(), 2000000);
+
+    std::vector<LatencyTracker::CommandStats> early = tracker.snapshot(LatencyTracker::kTimeoutNs);
+    check(matched && early.size() == 1 && early[0].unanswered == 0 && early[0].histogram.count() == 1,
+          "LatencyTracker pending within timeout");
+    std::vector<LatencyTracker::CommandStats> late = tracker.snapshot(LatencyTracker::kTimeoutNs + 1);
+    late = tracker.snapshot(2 * LatencyTracker::kTimeoutNs);
+    check(late.size() == 1 && late[0].cmd == SPI_CMD_RDCVA && late[0].unanswered == 1 &&
+          late[0].histogram.count() == 1 && !tracker.onRx(afe1.data(), 2 * LatencyTracker::kTimeoutNs),
+          "LatencyTracker unanswered TX expires");
+}
+
+/* Per-pixel min/max decimation of the cell history ------------------------*/
+void checkCellHistory()
+{
+    // AFE 2 RDCVA, one sample per ms for 3000 ms: the 1024 deep ring keeps
+    // 1976..2999 ms, cell 1 ramps by one code per sample
+    EmuCellHistory history;
+    const uint64_t t0 = 5000000000ull;
+    for (uint16_t k = 0; k < 3000; ++k) {
+        const uint16_t codes[3] = { 100, static_cast<uint16_t>(1000 + k), 300 };
+        history.append(2, 0, codes, t0 + k * 1000000ull);
+    }
+    check(history.afeCount() == 3 && history.latestNs() == t0 + 2999000000ull, "EmuCellHistory append");
+
+    // 10 buckets of 100 ms over 2000..2999: bucket b = codes 3000+100b .. 3099+100b
+    const int buckets = 10;
+    float mn[buckets], mx[buckets];
+    bool ok = history.decimate(2, 1, t0 + 2000000000ull, t0 + 3000000000ull, buckets, mn, mx) == 1000;
+    for (int b = 0; b < buckets; ++b)
+        ok = ok && std::fabs(mn[b] - static_cast<float>((3000 + 100 * b) * 150e-6 + 1.5)) < 1e-6f
+                && std::fabs(mx[b] - static_cast<float>((3099 + 100 * b) * 150e-6 + 1.5)) < 1e-6f;
+    check(ok, "EmuCellHistory decimate min/max");
+
+    // Window reaching past the ring: only what is kept, older buckets empty
+    ok = history.decimate(2, 1, t0 + 1000000000ull, t0 + 3000000000ull, buckets, mn, mx) == 1024;
+    for (int b = 0; b < 4; ++b)
+        ok = ok && std::isnan(mn[b]) && std::isnan(mx[b]);
+    ok = ok && std::fabs(mn[4] - static_cast<float>(2976 * 150e-6 + 1.5)) < 1e-6f;
+    check(ok, "EmuCellHistory ring wrap");
+    check(history.decimate(1, 1, t0, t0 + 3000000000ull, buckets, mn, mx) == 0 && std::isnan(mn[0]),
+          "EmuCellHistory empty channel");
+}
+
+/* Timing ------------------------------------------------------------------*/
+// Repeats fn (which processes `frames` frames of `bytes` total) until at
+// least g_minSeconds elapsed and prints ns/byte and frames/s.
+void measure(const char *name, size_t size, size_t bytes, size_t frames, const std::function<void()> &fn)
+{
+    fn();    // warm up caches / dispatch
+    size_t reps = 0;
+    const Clock::time_point start = Clock::now();
+    double seconds = 0.0;
+    do {
+        for (int i = 0; i < 64; ++i)
+            fn();
+        reps += 64;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (seconds < g_minSeconds);
+
+    const double nsPerByte = seconds * 1e9 / (static_cast<double>(reps) * static_cast<double>(bytes));
+    const double framesPerSec = static_cast<double>(reps) * static_cast<double>(frames) / seconds;
+    std::printf("%-24s %6zu %10.3f %14.0f\n", name, size, nsPerByte, framesPerSec);
+}
+
+void runBenchmarks()
+{
+    const size_t kFrames = 256;   // frames per call, e.g. one register group of a long chain
+    const int sizes[] = {2, 6, 16, 64, 240};
+    std::mt19937 rng(1);
+
+    std::printf("\n%-24s %6s %10s %14s\n", "variant", "bytes", "ns/byte", "frames/s");
+
+    for (int size : sizes) {
+        const size_t stride = static_cast<size_t>(size) + 1;
+        std::vector<uint8_t> buf(kFrames * stride + 1);
+        for (uint8_t &b : buf)
+            b = static_cast<uint8_t>(rng());
+        std::vector<uint16_t> out(kFrames);
+        const size_t total = kFrames * static_cast<size_t>(size);
+        uint8_t *data = buf.data();
+
+        measure("Pec15_Calc (ref)", size, total, kFrames, [&]() {
+            uint32_t acc = 0;
+            for (size_t k = 0; k < kFrames; ++k)
+                acc += Pec15_Calc(static_cast<uint8_t>(size), data + k * stride);
+            g_sink = acc;
+        });
+        PecBatch_SetEngine(PEC_BATCH_ENGINE_SCALAR);
+        measure("Pec15_CalcBatch scalar", size, total, kFrames, [&]() {
+            Pec15_CalcBatch(static_cast<uint8_t>(size), data, stride, kFrames, out.data());
+            g_sink = out[0];
+        });
+        PecBatch_SetEngine(PEC_BATCH_ENGINE_AVX2);
+        if (PecBatch_GetEngine() == PEC_BATCH_ENGINE_AVX2) {
+            measure("Pec15_CalcBatch avx2", size, total, kFrames, [&]() {
+                Pec15_CalcBatch(static_cast<uint8_t>(size), data, stride, kFrames, out.data());
+                g_sink = out[0];
+            });
+        }
+
+        typedef uint16_t (*Pec10Fn)(bool, int, uint8_t *);
+        const struct { const char *name; Pec10Fn fn; } pec10[] = {
+            {"pec10_calc_bitwise (ref)", pec10_calc_bitwise},
+            {"pec10_calc_table", pec10_calc_table},
+            {"pec10_calc_slice4", pec10_calc_slice4},
+            {"pec10_calc_slice8", pec10_calc_slice8},
+        };
+        for (const auto &v : pec10) {
+            measure(v.name, size, total, kFrames, [&]() {
+                uint32_t acc = 0;
+                for (size_t k = 0; k < kFrames; ++k)
+                    acc += v.fn(true, size, data + k * stride);
+                g_sink = acc;
+            });
+        }
+        PecBatch_SetEngine(PEC_BATCH_ENGINE_SCALAR);
+        measure("pec10_calc_batch scalar", size, total, kFrames, [&]() {
+            pec10_calc_batch(true, size, data, stride, kFrames, out.data());
+            g_sink = out[0];
+        });
+        PecBatch_SetEngine(PEC_BATCH_ENGINE_AVX2);
+        if (PecBatch_GetEngine() == PEC_BATCH_ENGINE_AVX2) {
+            measure("pec10_calc_batch avx2", size, total, kFrames, [&]() {
+                pec10_calc_batch(true, size, data, stride, kFrames, out.data());
+                g_sink = out[0];
+            });
+        }
+        PecBatch_SetEngine(PEC_BATCH_ENGINE_AUTO);
+    }
+
+    std::printf("\n");
+
+    // voltage_to_bytes over one frame worth of cells (3 per register group)
+    std::vector<double> volts(kFrames * 3);
+    for (size_t i = 0; i < volts.size(); ++i)
+        volts[i] = 1500000.0 + static_cast<double>(rng() % 3000000);
+    std::vector<uint8_t> codes(volts.size() * 2);
+    measure("voltage_to_bytes", 2, codes.size(), volts.size(), [&]() {
+        for (size_t i = 0; i < volts.size(); ++i)
+            EmuProtocol_VoltageToBytes(volts[i], &codes[i * 2]);
+        g_sink = codes[0];
+    });
+
+    // Full onSendPacket framing: header + cmd + index + data + DPEC + checksum
+    std::vector<uint8_t> packets(kFrames * APP_EMU_UART_PACKET_LEN);
+    const uint8_t cmd[4] = {0x00, 0x00, 0x00, 0x04};
+    measure("BuildRegPacket", APP_EMU_UART_PACKET_LEN, packets.size(), kFrames, [&]() {
+        for (size_t k = 0; k < kFrames; ++k)
+            EmuProtocol_BuildRegPacket(&packets[k * APP_EMU_UART_PACKET_LEN], cmd,
+                                       static_cast<uint8_t>(k), &codes[(k * 6) % (codes.size() - 6)], true);
+        g_sink = packets[APP_EMU_A_CHECKSUM];
+    });
+    measure("EmuFrame::encodeRegGroup", APP_EMU_UART_PACKET_LEN, packets.size(), kFrames, [&]() {
+        for (size_t k = 0; k < kFrames; ++k) {
+            const EmuFrame::Frame f = EmuFrame::encodeRegGroup<SPI_CMD_RDCVA>(
+                static_cast<uint8_t>(k), &codes[(k * 6) % (codes.size() - 6)]);
+            std::memcpy(&packets[k * APP_EMU_UART_PACKET_LEN], f.data(), f.size());
+        }
+        g_sink = packets[APP_EMU_A_CHECKSUM];
+    });
+    measure("Checksum", APP_EMU_UART_PACKET_LEN, packets.size(), kFrames, [&]() {
+        uint32_t acc = 0;
+        for (size_t k = 0; k < kFrames; ++k)
+            acc += EmuProtocol_Checksum(&packets[k * APP_EMU_UART_PACKET_LEN]);
+        g_sink = acc;
+    });
+
+    // Full-chain refresh: every cell and aux group of every AFE
+    for (int afeCount : {30, 256, APP_AFECASE_NUM_MAX}) {
+        EmuChainModel chain(afeCount);
+        chain.fillCells(3.7);
+        chain.fillAux(1.8);
+        std::vector<EmuFrame::Frame> frames;
+        const uint32_t groups = EmuChainModel::kCellGroupsMask | EmuChainModel::kAuxGroupsMask;
+        const size_t perRefresh = static_cast<size_t>(afeCount) * 11;
+        char name[40];
+        std::snprintf(name, sizeof(name), "ChainModel %d AFEs", afeCount);
+        measure(name, APP_EMU_UART_PACKET_LEN, perRefresh * APP_EMU_UART_PACKET_LEN, perRefresh, [&]() {
+            frames.clear();
+            chain.cellVolts(0)[0] += 1e-6;
+            chain.generate(groups, frames);
+            g_sink = frames.back()[APP_EMU_A_CHECKSUM];
+        });
+    }
+
+    // Same refresh as bursts: register bytes on the wire instead of 16 bytes frames
+    for (int afeCount : {30, APP_AFECASE_NUM_MAX}) {
+        EmuChainModel chain(afeCount);
+        chain.fillCells(3.7);
+        chain.fillAux(1.8);
+        std::vector<uint8_t> bursts;
+        const uint32_t groups = EmuChainModel::kCellGroupsMask | EmuChainModel::kAuxGroupsMask;
+        chain.generateBursts(groups, bursts);
+        const size_t perRefresh = static_cast<size_t>(afeCount) * 11;
+        char name[40];
+        std::snprintf(name, sizeof(name), "ChainModel bursts %d", afeCount);
+        measure(name, APP_EMU_UART_PACKET_LEN, bursts.size(), perRefresh, [&]() {
+            bursts.clear();
+            chain.cellVolts(0)[0] += 1e-6;
+            chain.generateBursts(groups, bursts);
+            g_sink = bursts.back();
+        });
+        std::printf("%-24s %zu bytes/refresh vs %zu as frames\n", "", bursts.size(),
+                    perRefresh * APP_EMU_UART_PACKET_LEN);
+    }
+
+    // Full-chain readback decode: DPEC + code -> V + scatter
+    {
+        EmuChainModel chain(APP_AFECASE_NUM_MAX);
+        chain.fillCells(3.7);
+        chain.fillAux(1.8);
+        std::vector<EmuFrame::Frame> frames;
+        chain.generate(EmuChainModel::kCellGroupsMask | EmuChainModel::kAuxGroupsMask, frames);
+        EmuRegisterDecoder decoder;
+        measure("RegisterDecoder 1024", APP_EMU_UART_PACKET_LEN, frames.size() * APP_EMU_UART_PACKET_LEN, frames.size(), [&]() {
+            for (const EmuFrame::Frame &f : frames)
+                decoder.addFrame(f.data(), static_cast<int>(f.size()));
+            g_sink = static_cast<uint32_t>(decoder.flush());
+        });
+    }
+
+    // TX/RX log line formatting
+    char line[HexFormat::bufferSize(APP_EMU_UART_PACKET_LEN)];
+    measure("HexFormat", APP_EMU_UART_PACKET_LEN, packets.size(), kFrames, [&]() {
+        size_t acc = 0;
+        for (size_t k = 0; k < kFrames; ++k)
+            acc += HexFormat::format(&packets[k * APP_EMU_UART_PACKET_LEN], APP_EMU_UART_PACKET_LEN, line);
+        g_sink = static_cast<uint32_t>(acc) + static_cast<uint8_t>(line[0]);
+    });
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+        g_minSeconds = std::atof(argv[1]);
+
+    checkGolden();
+    checkRandom();
+    checkChainModel();
+    checkBurst();
+    checkRegisterDecoder();
+    checkCellHistory();
+    checkBurstHold();
+    checkLatencyTimeout();
+    std::printf("golden/reference checks: %s (%d failures)\n", g_failures == 0 ? "PASS" : "FAIL", g_failures);
+    std::printf("batch engine (auto): %s\n", PecBatch_EngineName(PecBatch_GetEngine()));
+
+    if (g_minSeconds > 0.0)
+        runBenchmarks();
+
+    return g_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,48 @@
+# GUI independent protocol / CRC core, shared by EmulatorApp and the tools.
+# Keep this free of Qt widgets so console targets can include it as well.
+
+CONFIG += thread     # EmuCaptureWriter
+
+INCLUDEPATH += $$PWD
+DEPENDPATH  += $$PWD
+
+SOURCES += \
+    $$PWD/EmuCaptureWriter.cpp \
+    $$PWD/EmuCellHistory.cpp \
+    $$PWD/EmuChainModel.cpp \
+    $$PWD/EmuFirmwareModel.cpp \
+    $$PWD/EmuFrameDecoder.cpp \
+    $$PWD/EmuProtocol.c \
+    $$PWD/EmuRegisterDecoder.cpp \
+    $$PWD/HexFormat.cpp \
+    $$PWD/LatencyHistogram.cpp \
+    $$PWD/LatencyTracker.cpp \
+    $$PWD/LibCrc15Crc10TableCalc.c \
+    $$PWD/LibCrc10SliceCalc.cpp \
+    $$PWD/LibPecBatchCalc.cpp \
+    $$PWD/LinkStats.cpp \
+    $$PWD/StimulusGenerator.cpp
+
+HEADERS += \
+    $$PWD/EmuCapture.h \
+    $$PWD/EmuCaptureWriter.h \
+    $$PWD/EmuCellHistory.h \
+    $$PWD/EmuChainModel.h \
+    $$PWD/EmuFirmwareModel.h \
+    $$PWD/EmuFrame.h \
+    $$PWD/EmuFrameDecoder.h \
+    $$PWD/EmuProtocol.h \
+    $$PWD/EmuPtyStandIn.h \
+    $$PWD/EmuRegisterDecoder.h \
+    $$PWD/HexFormat.h \
+    $$PWD/LatencyHistogram.h \
+    $$PWD/LatencyTracker.h \
+    $$PWD/LibCrc15Crc10TableCalc.h \
+    $$PWD/LibCrcTables.h \
+    $$PWD/LibPecBatchCalc.h \
+    $$PWD/LinkStats.h \
+    $$PWD/SpscQueue.h \
+    $$PWD/StimulusGenerator.h
+
+# Pseudo-terminal firmware stand-in (EmulatorStandIn, --headless --standin)
+unix: SOURCES += $$PWD/EmuPtyStandIn.cpp
@@ -1,9 +1,33 @@
 #include "mainwindow.h"
+#include "HeadlessRunner.h"
 
 #include <QApplication>
+#include <QCoreApplication>
+#include <QTimer>
+
+#include <cstring>
+
+static bool isHeadless(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], "--headless") == 0)
+            return true;
+    return false;
+}
 
 int main(int argc, char *argv[])
 {
+    // 無 GUI 模式: 只建立 QCoreApplication，不產生任何 widget
+    if (isHeadless(argc, argv)) {
+        QCoreApplication a(argc, argv);
+        HeadlessRunner runner;
+        int rc = HeadlessRunner::ExitOk;
+        if (!runner.init(a.arguments(), rc))
+            return rc;
+        QTimer::singleShot(0, &runner, &HeadlessRunner::runNext);
+        return a.exec();
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
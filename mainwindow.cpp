@@ -1,8 +1,10 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include <QSerialPort>
-#include <QSerialPortInfo>
 #include <QMessageBox>
+#include <QFileDialog>
+#include <QFile>
+#include <QIntValidator>
 #include <QDebug>
 #include <QWidget>
 #include <QVBoxLayout>
@@ -11,58 +13,24 @@
 #include <QString>
 #include <QByteArray>
 #include <QTextStream>
+#include <QScrollBar>
+#include <QThread>
+#include <QListWidgetItem>
 #include <cstdint>
 #include <cmath>
 #include "LibCrc15Crc10TableCalc.h"
+#include "EmuProtocol.h"
+#include "EmuFrame.h"
+#include "EmuLog.h"
 
 #define EMULATOR_APP_NAME_STR         QString("EmulatorApp")
 #define EMULATOR_APP_VERSION_STR      QString("V1.2")
 
-#define SPI_CMD_RDCVA                              (0x0004)
-#define SPI_CMD_RDCVB                              (0x0006)
-#define SPI_CMD_RDCVC                              (0x0008)
-#define SPI_CMD_RDCVD                              (0x000A)
-#define SPI_CMD_RDCVE                              (0x0009)
-#define SPI_CMD_RDCVF                              (0x000B)
-
-#define SPI_CMD_RDAUXA                             (0x0019)
-#define SPI_CMD_RDAUXB                             (0x001A)
-#define SPI_CMD_RDAUXC                             (0x001B)
-#define SPI_CMD_RDAUXD                             (0x001F)
-#define SPI_CMD_RDAUXE                             (0x0036)
-
-#define SPI_CMD_WRCFGA                             (0x0001)
-#define SPI_CMD_RDCFGA                             (0x0002)
-
-#define SPI_CMD_WRCFGB                             (0x0024)
-#define SPI_CMD_RDCFGB                             (0x0026)
-
-
-#define APP_CMD_MASK                               (0x8000)
-#define APP_CMD_AFE_NUM                            (0x8001)
-#define APP_CMD_AFE_V_INC                          (0x8010)
-#define APP_CMD_AFE_SPIMODE                        (0x8020)
-
-#define APP_AFECASE_NUM_MAX                        (30)
-
-#define APP_EMU_UART_HAED1                         (0x55)
-#define APP_EMU_UART_HAED2                         (0xAA)
-
-#define APP_EMU_A_HEAD1                             (0)
-#define APP_EMU_A_HEAD2                             (1)
-#define APP_EMU_A_CMD1                              (2)
-#define APP_EMU_A_CMD2                              (3)
-#define APP_EMU_A_CMD3                              (4)
-#define APP_EMU_A_CMD4                              (5)
-#define APP_EMU_A_AFEINDEX                          (6)
-#define APP_EMU_A_DATA                              (7)
-#define APP_EMU_A_CHECKSUM                          (15)
-
-#define APP_EMU_UART_DATA_LEN                       (8)
-
-#define APP_EMU_UART_PACKET_LEN                     (16)
-
-#define APP_EMU_REMAIN_DATA_DELAY                   (100)   //ms
+#define APP_UI_RX_POLL_INTERVAL       (33)    //ms, RX 顯示更新週期 (~30Hz)
+#define APP_UI_LOG_CAPACITY           (100000)    //TX/RX 紀錄最多保留筆數
+#define APP_UI_STATS_INTERVAL         (1000)    //ms, 狀態列統計更新週期
+#define APP_UI_PORT_MESSAGE_TIME      (5000)    //ms, 重新開啟埠的訊息顯示時間
+#define APP_UI_REPLAY_SETTLE_TIME     (2 * APP_EMU_REMAIN_DATA_DELAY)    //ms, 重播結束後等待 RX
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -72,31 +40,27 @@ MainWindow::MainWindow(QWidget *parent)
 
     setWindowTitle(EMULATOR_APP_NAME_STR + " " + EMULATOR_APP_VERSION_STR);
 
-    // 初始化通訊用 serialPort
-    serial = new QSerialPort(this);
-
-    // 預設CMD1-CMD4選項
-    ui->comboBoxCmd->addItem("RDCVA", QVariant::fromValue(QByteArray::fromHex("00000004")));
-    ui->comboBoxCmd->addItem("RDCVB", QVariant::fromValue(QByteArray::fromHex("00000006")));
-    ui->comboBoxCmd->addItem("RDCVC", QVariant::fromValue(QByteArray::fromHex("00000008")));
-    ui->comboBoxCmd->addItem("RDCVD", QVariant::fromValue(QByteArray::fromHex("0000000A")));
-    ui->comboBoxCmd->addItem("RDCVE", QVariant::fromValue(QByteArray::fromHex("00000009")));
-    ui->comboBoxCmd->addItem("RDCVF", QVariant::fromValue(QByteArray::fromHex("0000000B")));
-
-    ui->comboBoxCmd->addItem("RDAUXA", QVariant::fromValue(QByteArray::fromHex("00000019")));
-    ui->comboBoxCmd->addItem("RDAUXB", QVariant::fromValue(QByteArray::fromHex("0000001A")));
-    ui->comboBoxCmd->addItem("RDAUXC", QVariant::fromValue(QByteArray::fromHex("0000001B")));
-    ui->comboBoxCmd->addItem("RDAUXD", QVariant::fromValue(QByteArray::fromHex("0000001F")));
-    ui->comboBoxCmd->addItem("RDAUXE", QVariant::fromValue(QByteArray::fromHex("00000036")));
+    // 每塊模擬板一個 I/O 執行緒 (SerialWorker 擁有 serialPort)，埠 0 為主要埠
+    ports = new PortManager(this);
+    worker = ports->primary();
+    connect(ports, &PortManager::portOpened, this, &MainWindow::onPortOpened);
+    connect(ports, &PortManager::portsChanged, this, &MainWindow::onPortsChanged);
+    connect(ports, &PortManager::portsScanned, this, &MainWindow::onPortsScanned);
+    connect(ports, &PortManager::portLost, this, [this](int id, const QString &message) {
+        ui->statusbar->showMessage(QString("Port %1 disconnected (%2), waiting for the device").arg(id).arg(message));
+    });
+    connect(ports, &PortManager::portReopened, this, [this](int id, bool ok, const QString &message) {
+        ui->statusbar->showMessage(ok ? QString("Port %1 reopened: %2").arg(id).arg(message)
+                                      : QString("Port %1 reopen failed: %2").arg(id).arg(message),
+                                   APP_UI_PORT_MESSAGE_TIME);
+    });
 
-    ui->comboBoxCmd->addItem("RDCFGA", QVariant::fromValue(QByteArray::fromHex("00000002")));
-    ui->comboBoxCmd->addItem("RDCFGB", QVariant::fromValue(QByteArray::fromHex("00000026")));
+    // 預設CMD1-CMD4選項 (RDCVA~F, RDAUXA~E, RDCFGA/B)
+    for (const EmuFrame::RegGroupInfo &info : EmuFrame::kRegGroups)
+        ui->comboBoxCmd->addItem(info.name, static_cast<uint>(info.cmd));
 
-    for (int i = 1; i <= APP_AFECASE_NUM_MAX; ++i)
-    {
-        ui->comboBoxAfeIndex->addItem(QString("AFE%1").arg(i), i - 1);
-        ui->comboBoxTotalAFE->addItem(QString::number(i), i); // 新增 AFE TOTAL 組數
-    }
+    // AFE 編號以 1 起算，長鏈 (數百顆) 用 spin box / 範圍輸入，不逐顆建立選項
+    ui->spinBoxTotalAFE->setMaximum(APP_AFECASE_NUM_MAX);
 
     ui->comboBoxPEC->addItem("Correct PEC", true);
     ui->comboBoxPEC->addItem("Incorrect PEC", false);
@@ -118,28 +82,78 @@ MainWindow::MainWindow(QWidget *parent)
     ui->comboBoxCmdType->addItem("RDCFGA", 0x20);
     ui->comboBoxCmdType->addItem("RDCFGB", 0x21);
 
-    // 初始化 comboBoxStartIndex 和 comboBoxEndIndex
-    for (int i = 1; i <= APP_AFECASE_NUM_MAX; ++i)
-    {
-        ui->comboBoxStartIndex->addItem(QString("AFE%1").arg(i), i - 1);
-        ui->comboBoxEndIndex->addItem(QString("AFE%1").arg(i), i - 1);
-    }
+    ui->spinBoxStartIndex->setMaximum(APP_AFECASE_NUM_MAX);
+    ui->spinBoxEndIndex->setMaximum(APP_AFECASE_NUM_MAX);
 
     connect(ui->btnScan, &QPushButton::clicked, this, &MainWindow::onScanPorts);
     connect(ui->btnOpen, &QPushButton::clicked, this, &MainWindow::onOpenPort);
+    connect(ui->btnProbeBaud, &QPushButton::clicked, this, &MainWindow::onProbeBaud);
+    connect(ui->btnAddPort, &QPushButton::clicked, this, &MainWindow::onAddPort);
+    connect(ui->btnRemovePort, &QPushButton::clicked, this, &MainWindow::onRemovePort);
+    onPortsChanged();
+
+    // 鮑率可自行輸入 (USB-UART 可到數 Mbaud)
+    for (qint32 rate : {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600,
+                        1000000, 1500000, 2000000, 3000000, 4000000})
+        ui->comboBoxBaud->addItem(QString::number(rate), rate);
+    ui->comboBoxBaud->setCurrentText(QString::number(QSerialPort::Baud115200));
+    ui->comboBoxBaud->setValidator(new QIntValidator(1200, 100000000, this));
+    ui->comboBoxFlow->addItem("No Flow Control", static_cast<int>(QSerialPort::NoFlowControl));
+    ui->comboBoxFlow->addItem("RTS/CTS", static_cast<int>(QSerialPort::HardwareControl));
+
+    connect(worker, &SerialWorker::probeStep, this, [this](qint32 baudRate, bool ok, const QString &detail) {
+        ui->labelProbe->setText(QString("%1 baud: %2 (%3)").arg(baudRate).arg(ok ? "OK" : "FAIL").arg(detail));
+    });
+    connect(worker, &SerialWorker::probeFinished, this, [this](qint32 best) {
+        ui->btnProbeBaud->setEnabled(true);
+        if (best == 0) {
+            ui->labelProbe->setText("Probe: no baud rate passed the loopback test");
+            return;
+        }
+        ui->comboBoxBaud->setCurrentText(QString::number(best));
+        ui->labelProbe->setText(QString("Probe: highest error-free rate %1 baud").arg(best));
+    });
+    connect(ui->btnCapture, &QPushButton::clicked, this, &MainWindow::onCapture);
+    connect(ui->btnReplay, &QPushButton::clicked, this, &MainWindow::onReplay);
+    connect(ui->btnExportLatency, &QPushButton::clicked, this, &MainWindow::onExportLatency);
+    connect(ui->btnResetLatency, &QPushButton::clicked, this, [this]() {
+        QMetaObject::invokeMethod(worker, &SerialWorker::resetLatency, Qt::QueuedConnection);
+    });
+
+    ui->comboBoxReplayMode->addItem("Original Timing", CaptureReplayer::OriginalTiming);
+    ui->comboBoxReplayMode->addItem("Speed Up", CaptureReplayer::Scaled);
+    ui->comboBoxReplayMode->addItem("As Fast As Link", CaptureReplayer::AsFastAsPossible);
+
+    // 紀錄檔重播 (獨立執行緒，經 bulk TX lane 送出)
+    replayThread = new QThread(this);
+    replayer = new CaptureReplayer(worker);
+    replayer->moveToThread(replayThread);
+    connect(replayThread, &QThread::finished, replayer, &QObject::deleteLater);
+    connect(replayer, &CaptureReplayer::finished, this, &MainWindow::onReplayFinished);
+    connect(replayer, &CaptureReplayer::progress, this, [this](quint64 sent, quint64 position, quint64 total) {
+        ui->labelReplay->setText(QString("TX %1 (%2/%3)  %4")
+                                     .arg(sent).arg(position).arg(total).arg(rxDiff.summary()));
+    });
+    connect(worker, &SerialWorker::portClosed, replayer, &CaptureReplayer::stop);
+    replayThread->start();
     connect(ui->btnSend, &QPushButton::clicked, this, &MainWindow::onSendPacket);
     connect(ui->btnSendTotalAFE, &QPushButton::clicked, this, &MainWindow::onSendTotalAFE);
     connect(ui->btnSendRangeVoltage, &QPushButton::clicked, this, &MainWindow::onSendRangeVoltage);
-    connect(serial, &QSerialPort::readyRead, this, &MainWindow::onSerialReceived);
+
+    // TX/RX 紀錄 (固定容量，只繪製可見的列)
+    txLog = new FrameLogModel(APP_UI_LOG_CAPACITY, this);
+    rxLog = new FrameLogModel(APP_UI_LOG_CAPACITY, this);
+    attachLogView(ui->listViewTx, txLog);
+    attachLogView(ui->listViewRx, rxLog);
 
     // 清除TX按鈕
     connect(ui->btnClearTx, &QPushButton::clicked, this, [=]() {
-        ui->textEditTx->clear();
+        txLog->clear();
     });
 
     // 清除RX按鈕
     connect(ui->btnClearRx, &QPushButton::clicked, this, [=]() {
-        ui->textEditRx->clear();
+        rxLog->clear();
     });
 
     crc10Edits[0] = ui->lineEditCrc10_0;
@@ -158,24 +172,23 @@ MainWindow::MainWindow(QWidget *parent)
     });
 
 
-    // 加入這段到 MainWindow 建構子中
+    // 狀態列顯示連線統計 (流量、錯誤、重新同步、寫入積壓)
     //---------------------------------------------
-    serialBuffer.clear();
-    rxDelayTimer = new QTimer(this);
-    rxDelayTimer->setSingleShot(true);
-    rxDelayTimer->setInterval(APP_EMU_REMAIN_DATA_DELAY); //ms 延遲顯示
-
-    connect(rxDelayTimer, &QTimer::timeout, this, [=]() {
-        if (!serialBuffer.isEmpty()) {
-            QString hexStr;
-            for (int i = 0; i < serialBuffer.size(); ++i)
-                hexStr += QString("%1 ").arg(static_cast<uint8_t>(serialBuffer[i]), 2, 16, QChar('0')).toUpper();
-
-            ui->textEditRx->append("RX (Rem): " + hexStr.trimmed());
-            qDebug() << "Received (Rem): " << serialBuffer.toHex(' ').toUpper();
-            serialBuffer.clear();
-        }
-    });
+    statusLink = new QLabel(this);
+    ui->statusbar->addWidget(statusLink, 1);
+    lastLinkSample = worker->linkStats().snapshot();
+    statsTimer = new QTimer(this);
+    statsTimer->setInterval(APP_UI_STATS_INTERVAL);
+    connect(statsTimer, &QTimer::timeout, this, &MainWindow::onStatsSample);
+    statsTimer->start();
+    //---------------------------------------------
+
+    // RX 顯示以固定頻率批次更新，不再每個封包觸發一次
+    //---------------------------------------------
+    rxPollTimer = new QTimer(this);
+    rxPollTimer->setInterval(APP_UI_RX_POLL_INTERVAL);
+    connect(rxPollTimer, &QTimer::timeout, this, &MainWindow::onRxPoll);
+    rxPollTimer->start();
     //---------------------------------------------
 
     ui->comboBoxSpiMode->addItem("SPI MODE0", 0);
@@ -185,6 +198,53 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(ui->btnSetSpiMode, &QPushButton::clicked, this, &MainWindow::onSendSpiMode);
 
+    // 波形產生 (獨立執行緒，經 worker 的 bulk TX lane 送出)
+    //------------------------------------------
+    stimThread = new QThread(this);
+    stimEngine = new StimulusEngine(worker);
+    stimEngine->moveToThread(stimThread);
+    connect(stimThread, &QThread::finished, stimEngine, &QObject::deleteLater);
+    stimThread->start();
+
+    stimPanel = new StimulusPanel();
+    ui->tabWidget->addTab(stimPanel, "Stimulus");
+    connect(stimPanel, &StimulusPanel::startRequested, this, [this](const StimulusConfig &config) {
+        const QVector<SerialWorker *> targets = ports->openWorkers();
+        if (targets.isEmpty()) {
+            QMessageBox::warning(this, "Error", "COM port not open");
+            return;
+        }
+        if (replaying) {
+            QMessageBox::warning(this, "Error", "Stop the replay first");
+            return;
+        }
+        // 同一時間基準送往所有已開啟的埠
+        StimulusEngine *engine = stimEngine;
+        QMetaObject::invokeMethod(stimEngine, [engine, targets, config]() {
+            engine->setTargets(targets);
+            engine->start(config);
+        }, Qt::QueuedConnection);
+        stimulating = true;
+        stimPanel->setRunning(true);
+    });
+    connect(stimPanel, &StimulusPanel::stopRequested, stimEngine, &StimulusEngine::stop);
+    connect(worker, &SerialWorker::portClosed, stimEngine, &StimulusEngine::stop);
+    connect(stimEngine, &StimulusEngine::stopped, stimPanel, [this]() {
+        stimulating = false;
+        stimPanel->setRunning(false);
+    });
+    connect(stimEngine, &StimulusEngine::statusUpdated, stimPanel, &StimulusPanel::setStatus);
+    //------------------------------------------
+
+
+    // RX 暫存器解碼 (電壓 / CFG)
+    //------------------------------------------
+    readbackPanel = new ReadbackPanel();
+    ui->tabWidget->addTab(readbackPanel, "Readback");
+    plotPanel = new PlotPanel(readbackPanel);
+    ui->tabWidget->addTab(plotPanel, "Plot");
+    //------------------------------------------
+
 
     //Add Hex String Head event
     //------------------------------------------
@@ -207,44 +267,328 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
-    if (serial->isOpen())
-        serial->close();
+    QMetaObject::invokeMethod(replayer, &CaptureReplayer::stop, Qt::BlockingQueuedConnection);
+    replayThread->quit();
+    replayThread->wait();
+    QMetaObject::invokeMethod(stimEngine, &StimulusEngine::stop, Qt::BlockingQueuedConnection);
+    stimThread->quit();
+    stimThread->wait();
+
+    delete ports;   // 關閉所有埠並結束各自的 I/O 執行緒
     delete ui;
 }
 
+void MainWindow::attachLogView(QListView *view, FrameLogModel *model)
+{
+    view->setModel(model);
+
+    // 捲軸在最底時才自動捲動，方便往上查看舊資料
+    connect(model, &FrameLogModel::rowsPublished, view, [view]() {
+        QScrollBar *bar = view->verticalScrollBar();
+        if (bar->value() >= bar->maximum() - 1)
+            view->scrollToBottom();
+    });
+}
+
 void MainWindow::onScanPorts()
 {
+    // 背景執行緒列舉，結果由 onPortsScanned 回報
+    ui->btnScan->setEnabled(false);
+    ports->scanPorts();
+}
+
+void MainWindow::onPortsScanned(const QList<SerialPortId> &list)
+{
+    // 熱插拔也會觸發，保留目前的選擇
+    const QString current = ui->comboBoxPort->currentText();
     ui->comboBoxPort->clear();
-    const auto infos = QSerialPortInfo::availablePorts();
-    for (const QSerialPortInfo &info : infos)
-        ui->comboBoxPort->addItem(info.portName());
+    for (const SerialPortId &port : list) {
+        ui->comboBoxPort->addItem(port.name);
+        if (!port.description.isEmpty())
+            ui->comboBoxPort->setItemData(ui->comboBoxPort->count() - 1, port.description, Qt::ToolTipRole);
+    }
+    const int index = ui->comboBoxPort->findText(current);
+    if (index >= 0)
+        ui->comboBoxPort->setCurrentIndex(index);
+    ui->btnScan->setEnabled(true);
+}
+
+bool MainWindow::currentSerialConfig(SerialConfig &config)
+{
+    bool ok = false;
+    config.baudRate = ui->comboBoxBaud->currentText().toInt(&ok);
+    if (!ok || config.baudRate <= 0) {
+        QMessageBox::warning(this, "Warning", "Invalid baud rate");
+        return false;
+    }
+    config.flowControl = static_cast<QSerialPort::FlowControl>(ui->comboBoxFlow->currentData().toInt());
+    return true;
 }
 
 void MainWindow::onOpenPort()
 {
-    if (serial->isOpen())
-        serial->close();
+    QString portName = ui->comboBoxPort->currentText();
+    if (portName.isEmpty()) {
+        QMessageBox::warning(this, "Warning", "Please select a COM port");
+        return;
+    }
+
+    SerialConfig config;
+    if (!currentSerialConfig(config))
+        return;
+
+    // 開埠在 I/O 執行緒執行，結果由 onPortOpened 回報
+    ports->openPort(0, portName, config);
+}
+
+void MainWindow::onAddPort()
+{
+    QString portName = ui->comboBoxPort->currentText();
+    if (portName.isEmpty()) {
+        QMessageBox::warning(this, "Warning", "Please select a COM port");
+        return;
+    }
+
+    SerialConfig config;
+    if (!currentSerialConfig(config))
+        return;
+
+    if (ports->addPort(portName, config) < 0)
+        QMessageBox::warning(this, "Warning", QString("At most %1 ports").arg(PortManager::kMaxPorts));
+}
+
+void MainWindow::onRemovePort()
+{
+    const QListWidgetItem *item = ui->listWidgetPorts->currentItem();
+    const int id = item ? item->data(Qt::UserRole).toInt() : 0;
+    if (id == 0) {
+        QMessageBox::warning(this, "Warning", "Select an added port (port 0 is the main port)");
+        return;
+    }
+
+    // 波形產生器可能還持有該埠，先停止並改回只送埠 0
+    StimulusEngine *engine = stimEngine;
+    SerialWorker *primary = worker;
+    QMetaObject::invokeMethod(stimEngine, [engine, primary]() {
+        engine->stop();
+        engine->setTargets({primary});
+    }, Qt::BlockingQueuedConnection);
+
+    ports->removePort(id);
+}
+
+void MainWindow::onPortsChanged()
+{
+    const int target = ui->comboBoxTarget->currentData().isValid() ? ui->comboBoxTarget->currentData().toInt()
+                                                                   : PortManager::kAllPorts;
+    ui->listWidgetPorts->clear();
+    ui->comboBoxTarget->clear();
+    ui->comboBoxTarget->addItem("All Ports", PortManager::kAllPorts);
+
+    for (int id : ports->portIds()) {
+        const SerialWorker *w = ports->worker(id);
+        const QString name = ports->portName(id).isEmpty() ? QString("-") : ports->portName(id);
+        QListWidgetItem *item = new QListWidgetItem(QString("Port %1: %2 (%3)")
+                                                        .arg(id).arg(name)
+                                                        .arg(w->isOpen() ? "open" : ports->waitingForDevice(id) ? "unplugged" : "closed"));
+        item->setData(Qt::UserRole, id);
+        ui->listWidgetPorts->addItem(item);
+        ui->comboBoxTarget->addItem(QString("Port %1").arg(id), id);
+    }
 
+    const int index = ui->comboBoxTarget->findData(target);
+    ui->comboBoxTarget->setCurrentIndex(index < 0 ? 0 : index);
+
+    // 新增的埠也要寫入紀錄檔
+    if (capture.isRunning())
+        ports->setCapture(&capture);
+}
+
+void MainWindow::onProbeBaud()
+{
     QString portName = ui->comboBoxPort->currentText();
     if (portName.isEmpty()) {
         QMessageBox::warning(this, "Warning", "Please select a COM port");
         return;
     }
 
-    serial->setPortName(portName);
-    serial->setBaudRate(QSerialPort::Baud115200);
-    serial->setDataBits(QSerialPort::Data8);
-    serial->setParity(QSerialPort::NoParity);
-    serial->setStopBits(QSerialPort::OneStop);
-    serial->setFlowControl(QSerialPort::NoFlowControl);
+    SerialConfig config;
+    if (!currentSerialConfig(config))
+        return;
+
+    if (QMessageBox::question(this, "Probe Baud",
+                              "The port will be closed and test frames sent at increasing baud rates.\n"
+                              "A loopback plug or echo firmware is required. Continue?") != QMessageBox::Yes)
+        return;
+
+    ui->btnProbeBaud->setEnabled(false);
+    SerialWorker *w = worker;
+    const QList<qint32> rates = SerialWorker::defaultProbeRates();
+    QMetaObject::invokeMethod(worker, [w, portName, config, rates]() {
+        w->probeBaudRates(portName, config, rates);
+    }, Qt::QueuedConnection);
+}
 
-    if (!serial->open(QIODevice::ReadWrite)) {
-        QMessageBox::critical(this, "Error", "Failed to open COM port");
+void MainWindow::onCapture()
+{
+    if (capturing) {
+        stopCapture();
+        return;
+    }
+
+    const QString path = QFileDialog::getSaveFileName(this, "Capture File", QString(),
+                                                      "Emulator Capture (*.emucap)");
+    if (path.isEmpty())
+        return;
+
+    if (!capture.start(QFile::encodeName(path).constData())) {
+        QMessageBox::critical(this, "Error", "Failed to create capture file\n" + path);
+        return;
+    }
+    ports->setCapture(&capture);     // 每個埠一個 source，portId 即埠號
+    capturing = true;
+    ui->btnCapture->setText("Stop Capture");
+    ui->labelCapture->setText(path);
+}
+
+void MainWindow::stopCapture()
+{
+    ports->setCapture(nullptr);
+    capture.stop();
+    capturing = false;
+    ui->btnCapture->setText("Start Capture");
+    if (capture.failed())
+        ui->labelCapture->setText(QString("Write failed, kept %1 records").arg(capture.recordsWritten()));
+    else
+        ui->labelCapture->setText(QString("Saved %1 records").arg(capture.recordsWritten()));
+}
+
+void MainWindow::onReplay()
+{
+    if (replaying) {
+        QMetaObject::invokeMethod(replayer, &CaptureReplayer::stop, Qt::QueuedConnection);
+        return;
+    }
+
+    if (!worker->isOpen()) {
+        QMessageBox::warning(this, "Error", "COM port not open");
+        return;
+    }
+    if (stimulating) {
+        QMessageBox::warning(this, "Error", "Stop the stimulus first");    // bulk lane 只能有一個 producer
+        return;
+    }
+
+    const QString path = QFileDialog::getOpenFileName(this, "Replay Capture", QString(),
+                                                      "Emulator Capture (*.emucap)");
+    if (path.isEmpty())
+        return;
+
+    QString error;
+    if (!rxDiff.open(path, &error)) {
+        QMessageBox::critical(this, "Error", "Failed to open capture file\n" + error);
+        return;
+    }
+
+    const int mode = ui->comboBoxReplayMode->currentData().toInt();
+    const double speed = ui->doubleSpinBoxReplaySpeed->value();
+    CaptureReplayer *r = replayer;
+    QMetaObject::invokeMethod(replayer, [r, path, mode, speed]() {
+        r->start(path, mode, speed);
+    }, Qt::QueuedConnection);
+
+    replaying = true;
+    ui->btnReplay->setText("Stop Replay");
+}
+
+void MainWindow::onReplayFinished(bool ok, const QString &message)
+{
+    replaying = false;
+    ui->btnReplay->setText("Replay...");
+
+    // 等最後的回應收完再結算
+    QTimer::singleShot(APP_UI_REPLAY_SETTLE_TIME, this, [this, ok, message]() {
+        if (replaying)
+            return;     // 已開始下一次重播
+        onRxPoll();
+        if (ok)
+            rxDiff.finish();
+        for (const QString &diff : rxDiff.differences())
+            qWarning().noquote() << diff;
+        ui->labelReplay->setText(message + "  " + rxDiff.summary());
+        rxDiff.close();
+    });
+}
+
+void MainWindow::onExportLatency()
+{
+    const QString path = QFileDialog::getSaveFileName(this, "Export Latency", QString(),
+                                                      "CSV (*.csv);;JSON (*.json)");
+    if (path.isEmpty())
+        return;
+
+    // 統計資料屬於 I/O 執行緒，在該執行緒取快照
+    std::vector<LatencyTracker::CommandStats> stats;
+    SerialWorker *w = worker;
+    QMetaObject::invokeMethod(worker, [w, &stats]() {
+        stats = w->latencySnapshot();
+    }, Qt::BlockingQueuedConnection);
+
+    const std::string text = path.endsWith(".json", Qt::CaseInsensitive) ? LatencyTracker::toJson(stats)
+                                                                          : LatencyTracker::toCsv(stats);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        file.write(text.data(), static_cast<qint64>(text.size())) != static_cast<qint64>(text.size())) {
+        QMessageBox::critical(this, "Error", "Failed to write " + path + "\n" + file.errorString());
+        return;
+    }
+}
+
+void MainWindow::onStatsSample()
+{
+    const LinkSnapshot now = worker->linkStats().snapshot();
+    const LinkRates rates = LinkStats::rates(lastLinkSample, now);
+    lastLinkSample = now;
+    QString text = QString::fromStdString(LinkStats::describe(now, rates));
+    const int portCount = static_cast<int>(ports->portIds().size());
+    if (portCount > 1)
+        text = QString("Ports open %1/%2 | P0 %3").arg(ports->openWorkers().size()).arg(portCount).arg(text);
+    statusLink->setText(text);
+
+    // 紀錄檔寫入失敗 (磁碟滿、裝置移除) 時寫入端已自行停止
+    if (capturing && capture.failed())
+        stopCapture();
+}
+
+void MainWindow::onPortOpened(int id, bool ok, const QString &message)
+{
+    onPortsChanged();
+    if (!ok) {
+        QMessageBox::critical(this, "Error", QString("Failed to open COM port (port %1)\n").arg(id) + message);
     } else {
-        QMessageBox::information(this, "Success", "COM port opened successfully");
+        QMessageBox::information(this, "Success", QString("COM port opened successfully (port %1)").arg(id));
     }
 }
 
+// "1-256,300" -> 0-based AFE indexes, false on syntax error or out of range
+static bool parseAfeSelection(const QString &text, std::vector<uint16_t> &out)
+{
+    out.clear();
+    const QStringList items = text.split(',', Qt::SkipEmptyParts);
+    for (const QString &item : items) {
+        const QStringList bounds = item.split('-');
+        bool ok1 = false, ok2 = false;
+        const int first = bounds.at(0).trimmed().toInt(&ok1);
+        const int last = (bounds.size() == 2) ? bounds.at(1).trimmed().toInt(&ok2) : first;
+        if (!ok1 || (bounds.size() == 2 && !ok2) || bounds.size() > 2 ||
+            first < 1 || last < first || last > APP_AFECASE_NUM_MAX)
+            return false;
+        for (int afe = first; afe <= last; ++afe)
+            out.push_back(static_cast<uint16_t>(afe - 1));
+    }
+    return !out.empty();
+}
+
 static bool parseHexIfNeeded(const QString& input, uint16_t& out)
 {
     if (input.startsWith("0x", Qt::CaseInsensitive)) {
@@ -255,12 +599,6 @@ static bool parseHexIfNeeded(const QString& input, uint16_t& out)
     return false;
 }
 
-static void voltage_to_bytes(double voltage_uV, uint8_t* out_bytes) {
-    uint16_t raw = static_cast<uint16_t>((voltage_uV - 1500000.0) / 150.0);
-    out_bytes[0] = static_cast<uint8_t>(raw & 0xFF);
-    out_bytes[1] = static_cast<uint8_t>((raw >> 8) & 0xFF);
-}
-
 void MainWindow::onSendPacket()
 {
     if (ui->lineEditV1->text().isEmpty() || ui->lineEditV2->text().isEmpty() || ui->lineEditV3->text().isEmpty()) {
@@ -268,21 +606,11 @@ void MainWindow::onSendPacket()
         return;
     }
 
-    if (!serial->isOpen()) {
+    if (!targetOpen()) {
         QMessageBox::warning(this, "Error", "COM port not open");
         return;
     }
 
-    QByteArray packet(16, 0);
-    packet[0] = APP_EMU_UART_HAED1;
-    packet[1] = APP_EMU_UART_HAED2;
-
-    QByteArray cmdBytes = ui->comboBoxCmd->currentData().toByteArray();
-    packet.replace(2, 4, cmdBytes);
-
-    uint8_t afe_index = static_cast<uint8_t>(ui->comboBoxAfeIndex->currentData().toUInt());
-    packet[6] = afe_index;
-
     uint8_t data[7];    
     uint16_t value = 0;
 
@@ -297,7 +625,7 @@ void MainWindow::onSendPacket()
         data[1] = (value >> 8) & 0xFF;
     } else {
         double v = ui->lineEditV1->text().toDouble() * 1000000;
-        voltage_to_bytes(v, &data[0]);
+        EmuProtocol_VoltageToBytes(v, &data[0]);
     }
 
     // V2
@@ -306,7 +634,7 @@ void MainWindow::onSendPacket()
         data[3] = (value >> 8) & 0xFF;
     } else {
         double v = ui->lineEditV2->text().toDouble() * 1000000;
-        voltage_to_bytes(v, &data[2]);
+        EmuProtocol_VoltageToBytes(v, &data[2]);
     }
 
     // V3
@@ -315,95 +643,48 @@ void MainWindow::onSendPacket()
         data[5] = (value >> 8) & 0xFF;
     } else {
         double v = ui->lineEditV3->text().toDouble() * 1000000;
-        voltage_to_bytes(v, &data[4]);
+        EmuProtocol_VoltageToBytes(v, &data[4]);
     }
 
-    for (int i = 0; i < 6; ++i)
-        packet[7 + i] = data[i];
+    std::vector<uint16_t> afes;
+    if (!parseAfeSelection(ui->lineEditAfeIndex->text(), afes)) {
+        QMessageBox::warning(this, "Input Error",
+                             QString("Invalid AFE index list (e.g. 1-256,300, max %1).").arg(APP_AFECASE_NUM_MAX));
+        return;
+    }
 
-    //CRC 10(DPEC) Calc
+    uint16_t u16Cmd = static_cast<uint16_t>(ui->comboBoxCmd->currentData().toUInt());
     bool correctPEC = ui->comboBoxPEC->currentData().toBool();
-    uint16_t crc = pec10_calc(true, 6, data);
-    uint8_t dpec[2] = { static_cast<uint8_t>(crc >> 8), static_cast<uint8_t>(crc & 0xFF) };
-    if (!correctPEC)
-        dpec[1] ^= 0xFF;
-
-    packet[13] = dpec[0];    //Data 7
-    packet[14] = dpec[1];    //Data 8
-
-    uint8_t checksum = 0;
-    for (int i = 0; i < 15; ++i)
-        checksum += static_cast<uint8_t>(packet[i]);
-    packet[15] = checksum;
 
-    serial->write(packet);
-
-    QString hexStr;
-    for (int i = 0; i < 16; ++i)
-        hexStr += QString("%1 ").arg(static_cast<uint8_t>(packet[i]), 2, 16, QChar('0')).toUpper();
+    // 組成 16 Bytes 封包 (含 DPEC 與 Checksum)，選取的每顆 AFE 各一個
+    EmuFrame::RegGroupEncoder encode = EmuFrame::regGroupEncoder(u16Cmd);
+    if (encode == nullptr)
+        return;
 
-    ui->textEditTx->append("TX: " + hexStr.trimmed());
-    qDebug() << "Sent Packet: " << packet.toHex(' ').toUpper();
+    std::vector<EmuFrame::Frame> frames;
+    frames.reserve(afes.size());
+    for (uint16_t afe : afes)
+        frames.push_back(encode(afe, data, correctPEC));
+    sendFrames(frames, "Sent Packet:");
 }
 
 void MainWindow::onSendTotalAFE()
 {
-    uint16_t u16Cmd;
-
-    u16Cmd = APP_CMD_AFE_NUM;
-
-    if (!serial->isOpen()) {
+    if (!targetOpen()) {
         QMessageBox::warning(this, "Error", "COM port not open");
         return;
     }
 
-    QByteArray packet(16, 0);
-    packet[0] = APP_EMU_UART_HAED1;
-    packet[1] = APP_EMU_UART_HAED2;
-
-    packet[2] = 0x00;
-    packet[3] = 0x00;
-    packet[4] = (u16Cmd >> 8);
-    packet[5] = (u16Cmd & 0xFF);
-
-    packet[6] = 0x00; // AFE index 可設為0
-
-    uint8_t afe_total = static_cast<uint8_t>(ui->comboBoxTotalAFE->currentData().toUInt());
-    packet[7] = afe_total;
+    uint16_t afe_total = static_cast<uint16_t>(ui->spinBoxTotalAFE->value());
 
     // Data2 = 是否初始化（0x01 表示需要初始化）
-    if(ui->checkBoxInitDevice->isChecked() == true)
-    {
-        packet[8] = 0x01;
-    }else
-    {
-        packet[8] = 0x00;
-    }
-
-    for (int i = 9; i < 15; ++i)
-        packet[i] = 0x00;
-
-    uint8_t checksum = 0;
-    for (int i = 0; i < 15; ++i)
-        checksum += static_cast<uint8_t>(packet[i]);
+    bool initDevice = ui->checkBoxInitDevice->isChecked();
 
-    packet[15] = checksum;
-
-    serial->write(packet);
-
-    QString hexStr;
-    for (int i = 0; i < 16; ++i)
-        hexStr += QString("%1 ").arg(static_cast<uint8_t>(packet[i]), 2, 16, QChar('0')).toUpper();
-
-    ui->textEditTx->append("TX: " + hexStr.trimmed());
-    qDebug() << "Sent AFE Total Packet: " << packet.toHex(' ').toUpper();
+    sendFrame(EmuFrame::encodeAfeTotal(afe_total, initDevice), "Sent AFE Total Packet:");
 }
 
 void MainWindow::onSendRangeVoltage()
 {
-    uint16_t u16Cmd;
-    u16Cmd = APP_CMD_AFE_V_INC;
-
     QString strStart = ui->lineEditStartVolt->text();
     QString strStep  = ui->lineEditStepVolt->text();
 
@@ -412,28 +693,23 @@ void MainWindow::onSendRangeVoltage()
         return;
     }
 
-    if (!serial->isOpen()) {
+    if (!targetOpen()) {
         QMessageBox::warning(this, "Error", "COM port not open");
         return;
     }
 
-    QByteArray packet(16, 0);
-    packet[0] = APP_EMU_UART_HAED1;
-    packet[1] = APP_EMU_UART_HAED2;
-    packet[2] = 0x00;
-    packet[3] = 0x00;
-    packet[4] = (u16Cmd>>8);
-    packet[5] = (u16Cmd & 0xFF);
-    packet[6] = 0x00; // AFE index 無使用
-
     // Data1 = CMD選項
-    packet[7] = static_cast<uint8_t>(ui->comboBoxCmdType->currentData().toUInt());
+    uint8_t cmdType = static_cast<uint8_t>(ui->comboBoxCmdType->currentData().toUInt());
 
-    // Data2 = 起始 AFE Index
-    packet[8] = static_cast<uint8_t>(ui->comboBoxStartIndex->currentData().toUInt());
+    // Data2 = 起始 AFE Index (bits 11:8 在 Data8)
+    uint16_t startIndex = static_cast<uint16_t>(ui->spinBoxStartIndex->value() - 1);
 
     // Data3 = 結束 AFE Index
-    packet[9] = static_cast<uint8_t>(ui->comboBoxEndIndex->currentData().toUInt());
+    uint16_t endIndex = static_cast<uint16_t>(ui->spinBoxEndIndex->value() - 1);
+    if (endIndex < startIndex) {
+        QMessageBox::warning(this, "Input Error", "AFE End Index must not be before AFE Start Index.");
+        return;
+    }
 
     // Data4~5 = 開始電壓，判斷是否為 HEX 字串
     uint16_t start_u16 = 0;
@@ -447,11 +723,9 @@ void MainWindow::onSendRangeVoltage()
     } else {
         double startV = strStart.toDouble() * 1000000.0; // V to μV
         uint8_t bytesV[2];
-        voltage_to_bytes(startV, bytesV);
+        EmuProtocol_VoltageToBytes(startV, bytesV);
         start_u16 = (bytesV[1] << 8) | bytesV[0]; // Big Endian 組合
     }
-    packet[10] = (start_u16 >> 8) & 0xFF;
-    packet[11] = start_u16 & 0xFF;
 
     // Data6~7 = 遞增電壓，判斷是否為 HEX 字串
     uint16_t step_u16 = 0;
@@ -466,50 +740,34 @@ void MainWindow::onSendRangeVoltage()
         step_u16 = static_cast<uint16_t>(strStep.toUInt());
     }
 
-    packet[12] = (step_u16 >> 8) & 0xFF;
-    packet[13] = step_u16 & 0xFF;
-
-    packet[14] = 0x00; // 保留位
-
-    // Checksum B0~B14
-    uint8_t checksum = 0;
-    for (int i = 0; i < 15; ++i)
-        checksum += static_cast<uint8_t>(packet[i]);
-
-    packet[15] = checksum;
-
-    serial->write(packet);
-
-    QString hexStr;
-    for (int i = 0; i < 16; ++i)
-        hexStr += QString("%1 ").arg(static_cast<uint8_t>(packet[i]), 2, 16, QChar('0')).toUpper();
-
-    ui->textEditTx->append("TX: " + hexStr.trimmed());
-    qDebug() << "SendRangeVoltage: " << packet.toHex(' ').toUpper();
+    sendFrame(EmuFrame::encodeRangeVoltage(cmdType, startIndex, endIndex, start_u16, step_u16), "SendRangeVoltage:");
 }
 
-void MainWindow::onSerialReceived()
+void MainWindow::onRxPoll()
 {
-    serialBuffer += serial->readAll();
-
-    // 顯示完整的 16 Bytes 封包
-    while (serialBuffer.size() >= APP_EMU_UART_PACKET_LEN) {
-        QByteArray onePacket = serialBuffer.left(APP_EMU_UART_PACKET_LEN);
-        serialBuffer.remove(0, APP_EMU_UART_PACKET_LEN);
-
-        QString hexStr;
-        for (int i = 0; i < onePacket.size(); ++i)
-            hexStr += QString("%1 ").arg(static_cast<uint8_t>(onePacket[i]), 2, 16, QChar('0')).toUpper();
-
-        ui->textEditRx->append("RX: " + hexStr.trimmed());
-        qDebug() << "Received (16B): " << onePacket.toHex(' ').toUpper();
-    }
-
-    // 若還有殘留不滿16 bytes，啟動延遲顯示定時器
-    if (!serialBuffer.isEmpty()) {
-        rxDelayTimer->start();  // 每次接收到資料就重新啟動倒數
+    MergedRxRecord batch[256];
+    size_t n;
+
+    // 所有埠的 RX 依時間戳合併成一個串流
+    while ((n = ports->popRx(batch, 256)) > 0) {
+        for (size_t k = 0; k < n; ++k) {
+            const EmuRxRecord &rec = batch[k].rec;
+            FrameLogModel::Kind kind = FrameLogModel::Rx;
+            switch (rec.kind) {
+            case EmuRxRecord::Frame:     kind = FrameLogModel::Rx; break;
+            case EmuRxRecord::DpecError: kind = FrameLogModel::RxDpecError; break;
+            case EmuRxRecord::Garbage:   kind = FrameLogModel::RxDrop; break;   // 找 Header 時丟棄的資料
+            case EmuRxRecord::Remain:    kind = FrameLogModel::RxRemain; break;
+            case EmuRxRecord::Burst:     kind = FrameLogModel::RxBurst; break;
+            }
+            rxLog->append(kind, rec.data, rec.size, batch[k].port);
+            readbackPanel->addRecord(batch[k].port, rec);
+            if (rxDiff.isOpen() && batch[k].port == RxStreamDiff::kPort)     // 重播只走埠 0
+                rxDiff.feed(rec.kind, rec.data, rec.size);
+            EmuLog_Traffic("Received:", rec.data, rec.size);
+        }
+        readbackPanel->flush();
     }
-
 }
 
 void MainWindow::onCalcCrc15()
@@ -596,41 +854,46 @@ void MainWindow::on_comboBoxCmdType_currentIndexChanged(int index)
 
 void MainWindow::onSendSpiMode()
 {
-    if (!serial->isOpen()) {
+    if (!targetOpen()) {
         QMessageBox::warning(this, "Error", "COM port not open");
         return;
     }
 
-    uint16_t u16Cmd = APP_CMD_AFE_SPIMODE;
     uint8_t modeIndex = static_cast<uint8_t>(ui->comboBoxSpiMode->currentData().toUInt());
 
-    QByteArray packet(16, 0);
-    packet[0] = APP_EMU_UART_HAED1;
-    packet[1] = APP_EMU_UART_HAED2;
-    packet[2] = 0x00;  // Reserved
-    packet[3] = 0x00;  // Reserved
-    packet[4] = (u16Cmd >> 8) & 0xFF;
-    packet[5] = (u16Cmd & 0xFF);
-    packet[6] = 0x00;  // AFE Index (not used)
-    packet[7] = modeIndex;
-
-    // Fill rest as 0
-    for (int i = 8; i < 15; ++i)
-        packet[i] = 0x00;
-
-    uint8_t checksum = 0;
-    for (int i = 0; i < 15; ++i)
-        checksum += static_cast<uint8_t>(packet[i]);
-    packet[15] = checksum;
-
-    serial->write(packet);
-
-    QString hexStr;
-    for (int i = 0; i < 16; ++i)
-        hexStr += QString("%1 ").arg(static_cast<uint8_t>(packet[i]), 2, 16, QChar('0')).toUpper();
-
-    ui->textEditTx->append("TX: " + hexStr.trimmed());
-    qDebug() << "Sent SPI Mode Set Packet: " << packet.toHex(' ').toUpper();
+    sendFrame(EmuFrame::encodeSpiMode(modeIndex), "Sent SPI Mode Set Packet:");
+}
+
+bool MainWindow::targetOpen() const
+{
+    const int target = ui->comboBoxTarget->currentData().toInt();
+    if (target == PortManager::kAllPorts)
+        return ports->anyOpen();
+    const SerialWorker *w = ports->worker(target);
+    return w && w->isOpen();
+}
+
+void MainWindow::sendFrame(const EmuFrame::Frame &frame, const char *tag)
+{
+    sendFrames({frame}, tag);
+}
+
+void MainWindow::sendFrames(const std::vector<EmuFrame::Frame> &frames, const char *tag)
+{
+    // 送往選擇的埠，或廣播到所有已開啟的埠
+    const int target = ui->comboBoxTarget->currentData().toInt();
+    const int expected = (target == PortManager::kAllPorts) ? static_cast<int>(ports->openWorkers().size()) : 1;
+    size_t dropped = 0;
+    for (const EmuFrame::Frame &frame : frames) {
+        if (ports->post(target, frame.data(), static_cast<int>(frame.size())) < expected)
+            ++dropped;
+        txLog->append(FrameLogModel::Tx, frame.data(), static_cast<int>(frame.size()),
+                      static_cast<uint8_t>(target == PortManager::kAllPorts ? 0 : target));
+        EmuLog_Traffic(tag, frame.data(), static_cast<int>(frame.size()));
+    }
+    if (dropped > 0)
+        QMessageBox::warning(this, "Warning", QString("TX queue full, %1 of %2 frames not sent")
+                                                  .arg(dropped).arg(frames.size()));
 }
 
 void MainWindow::onLineEditSetHexStringHead()
@@ -5,7 +5,25 @@
 #include <QSerialPort>
 #include <QMouseEvent>
 #include <QLineEdit>
+#include <QListView>
+#include <QLabel>
 #include <QTimer>
+#include <QThread>
+
+#include <vector>
+
+#include "EmuCaptureWriter.h"
+#include "EmuFrame.h"
+#include "CaptureReplayer.h"
+#include "FrameLogModel.h"
+#include "LinkStats.h"
+#include "PlotPanel.h"
+#include "PortManager.h"
+#include "ReadbackPanel.h"
+#include "RxStreamDiff.h"
+#include "SerialWorker.h"
+#include "StimulusEngine.h"
+#include "StimulusPanel.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -21,11 +39,22 @@ public:
 
 private slots:
     void onScanPorts();        // 掃描可用的COM埠
+    void onPortsScanned(const QList<SerialPortId> &list);
     void onOpenPort();         // 開啟選擇的COM埠
     void onSendPacket();       // 傳送16Bytes資料封包
     void onSendTotalAFE();     // 傳送AFE總數設定封包
     void onSendRangeVoltage(); // 傳送設定範圍電壓封包
-    void onSerialReceived();   // 接收資料事件處理
+    void onRxPoll();           // 批次取出 I/O 執行緒收到的資料
+    void onPortOpened(int id, bool ok, const QString &message);
+    void onCapture();          // 開始/停止 TX/RX 二進位紀錄
+    void onReplay();           // 重播紀錄檔的 TX 並比對 RX
+    void onReplayFinished(bool ok, const QString &message);
+    void onExportLatency();    // 匯出各命令回應時間統計 (CSV/JSON)
+    void onStatsSample();      // 更新狀態列的連線統計
+    void onProbeBaud();        // 逐步提高鮑率做回送測試
+    void onAddPort();          // 以目前設定加開一個 COM 埠 (另一塊模擬板)
+    void onRemovePort();
+    void onPortsChanged();     // 更新埠清單與傳送對象
     void onCalcCrc15();
     void onCalcCrc10();
 
@@ -36,11 +65,35 @@ private slots:
     void onLineEditSetHexStringHead();
 
 private:
+    void attachLogView(QListView *view, FrameLogModel *model);
+    bool currentSerialConfig(SerialConfig &config);
+    void sendFrame(const EmuFrame::Frame &frame, const char *tag);
+    void sendFrames(const std::vector<EmuFrame::Frame> &frames, const char *tag);   // 多顆 AFE 一次送出
+    bool targetOpen() const;   // 目前傳送對象中有已開啟的埠
+    void stopCapture();        // 手動停止或寫檔失敗
+
     Ui::MainWindow *ui;
-    QSerialPort *serial;       // 串口物件
+    PortManager *ports;        // 每個埠各自一個 I/O 執行緒
+    SerialWorker *worker;      // 埠 0 (ports->primary())
     QLineEdit* crc10Edits[7];  // 對應 lineEditCrc10_0 ~ _6
-    QByteArray serialBuffer;   // Buffer 用來暫存串口接收資料
-    QTimer *rxDelayTimer;      // 延遲顯示用的 Timer
+    QTimer *rxPollTimer;       // RX 顯示更新 Timer
+    FrameLogModel *txLog;      // TX 紀錄
+    FrameLogModel *rxLog;      // RX 紀錄
+    QThread *stimThread;       // 波形產生執行緒
+    StimulusEngine *stimEngine;
+    StimulusPanel *stimPanel;  // Stimulus 分頁
+    ReadbackPanel *readbackPanel;  // Readback 分頁: RX 解碼後的電壓
+    PlotPanel *plotPanel;      // Plot 分頁: 電壓波形 / 熱圖
+    EmuCaptureWriter capture;  // TX/RX 二進位紀錄 (背景執行緒寫檔)
+    bool capturing = false;    // 寫檔失敗時 capture.isRunning() 已變 false
+    QThread *replayThread;     // 重播執行緒
+    CaptureReplayer *replayer;
+    RxStreamDiff rxDiff;       // 重播時即時比對 RX
+    bool replaying = false;
+    bool stimulating = false;  // bulk lane 同時只給波形或重播使用
+    QTimer *statsTimer;        // 連線統計取樣 Timer
+    QLabel *statusLink;        // 狀態列: 流量 / 錯誤計數
+    LinkSnapshot lastLinkSample;
 };
 
 /*
@@ -0,0 +1,14 @@
+# Emulator board stand-in on a pseudo-terminal, console only (POSIX).
+#   ./EmulatorStandIn [--baud N] [--delay-us N] [--link /tmp/ttyEMU0] [--stats s]
+# Prints the port path, then serves until SIGINT / SIGTERM.
+
+TEMPLATE = app
+TARGET = EmulatorStandIn
+
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+include(../emucore.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,97 @@
+// EmulatorStandIn - the emulator board firmware on a pseudo-terminal.
+//
+// Lets EmulatorApp (GUI "Find COM Port" lists /tmp/ttyEMU*, or --headless
+// --port /tmp/ttyEMU0) and CI jobs run without the physical board. The
+// first stdout line is the port path to open; counters go to stderr every
+// --stats seconds and once more on exit.
+
+#include "EmuPtyStandIn.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <pthread.h>
+#include <time.h>
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: EmulatorStandIn [--baud N] [--delay-us N] [--link PATH] [--stats SECONDS]\n"
+                 "  --baud      virtual line rate, 0 = unlimited (default 115200)\n"
+                 "  --delay-us  firmware response delay per frame (default 0)\n"
+                 "  --link      symlink to the pty (default first free /tmp/ttyEMU<N>)\n"
+                 "  --stats     print counters every SECONDS (default 0 = on exit only)\n");
+}
+
+void printStats(const EmuPtyStandIn &standIn)
+{
+    const EmuPtyStandIn::Stats s = standIn.stats();
+    std::fprintf(stderr, "rx %llu B, tx %llu B, frames %llu, dpec err %llu, dropped %llu B\n",
+                 static_cast<unsigned long long>(s.rxBytes), static_cast<unsigned long long>(s.txBytes),
+                 static_cast<unsigned long long>(s.frames), static_cast<unsigned long long>(s.dpecErrors),
+                 static_cast<unsigned long long>(s.droppedBytes));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    EmuPtyStandIn::Config config;
+    config.baudRate = 115200;
+    int statsSeconds = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--baud") == 0 && hasValue)
+            config.baudRate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        else if (std::strcmp(argv[i], "--delay-us") == 0 && hasValue)
+            config.responseDelayUs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        else if (std::strcmp(argv[i], "--link") == 0 && hasValue)
+            config.linkPath = argv[++i];
+        else if (std::strcmp(argv[i], "--stats") == 0 && hasValue)
+            statsSeconds = std::atoi(argv[++i]);
+        else {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (config.linkPath.empty())
+        config.linkPath = EmuPtyStandIn::nextFreeLinkPath();
+
+    // 由主執行緒等待結束信號，stand-in 執行緒不受影響
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    EmuPtyStandIn standIn;
+    std::string error;
+    if (!standIn.start(config, &error)) {
+        std::fprintf(stderr, "cannot start stand-in: %s\n", error.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("%s\n", standIn.linkPath().empty() ? standIn.slavePath().c_str() : standIn.linkPath().c_str());
+    std::fflush(stdout);
+    std::fprintf(stderr, "stand-in on %s, %u baud%s, response delay %u us\n", standIn.slavePath().c_str(),
+                 config.baudRate, config.baudRate ? "" : " (unlimited)", config.responseDelayUs);
+
+    if (statsSeconds > 0) {
+        const struct timespec period = {statsSeconds, 0};
+        while (sigtimedwait(&signals, nullptr, &period) < 0)
+            printStats(standIn);
+    } else {
+        int sig = 0;
+        sigwait(&signals, &sig);
+    }
+
+    standIn.stop();
+    printStats(standIn);
+    return EXIT_SUCCESS;
+}